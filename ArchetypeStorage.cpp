@@ -0,0 +1,207 @@
+#include "ArchetypeStorage.h"
+#include "GameObject.h"
+#include "Logger.h"
+#include <algorithm>
+
+// ==================== Архетип ====================
+Archetype::Archetype(std::vector<const ComponentTypeInfo*> types) : types(std::move(types)) {
+    // Сколько объектов помещается в блок с учетом выравнивания колонок
+    size_t rowBytes = 0;
+    size_t alignmentSlack = 0;
+    for (const ComponentTypeInfo* type : this->types) {
+        rowBytes += type->size;
+        alignmentSlack += type->alignment;
+    }
+    chunkCapacity = rowBytes > 0 && ChunkBytes > alignmentSlack
+        ? (ChunkBytes - alignmentSlack) / rowBytes
+        : 0;
+    if (chunkCapacity == 0) chunkCapacity = 1;
+
+    // Колонки идут подряд: [T0 x capacity][T1 x capacity]...
+    size_t offset = 0;
+    for (const ComponentTypeInfo* type : this->types) {
+        offset = (offset + type->alignment - 1) / type->alignment * type->alignment;
+        columnOffsets.push_back(offset);
+        offset += type->size * chunkCapacity;
+    }
+    chunkBytes = offset > 0 ? offset : 1;
+}
+
+Archetype::~Archetype() {
+    // Оставшиеся компоненты разрушаются вместе с архетипом
+    for (auto& chunk : chunks) {
+        for (size_t row = 0; row < chunk.count; ++row) {
+            for (size_t column = 0; column < types.size(); ++column) {
+                types[column]->destroy(chunk.memory + columnOffsets[column] + row * types[column]->size);
+            }
+        }
+        ::operator delete(chunk.memory, std::align_val_t(ChunkAlignment));
+    }
+}
+
+int Archetype::findColumn(std::type_index type) const {
+    // Типов в архетипе немного - линейный поиск быстрее хэш-таблицы
+    for (size_t i = 0; i < types.size(); ++i) {
+        if (types[i]->type == type) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+size_t Archetype::getEntityCount() const {
+    size_t total = 0;
+    for (const auto& chunk : chunks) {
+        total += chunk.count;
+    }
+    return total;
+}
+
+EntityLocation Archetype::allocateRow(EntityHandle owner) {
+    if (chunks.empty() || chunks.back().count == chunkCapacity) {
+        Chunk chunk;
+        chunk.memory = static_cast<std::byte*>(::operator new(chunkBytes, std::align_val_t(ChunkAlignment)));
+        chunk.owners.reserve(chunkCapacity);
+        chunks.push_back(std::move(chunk));
+    }
+
+    Chunk& chunk = chunks.back();
+    EntityLocation location;
+    location.archetype = this;
+    location.chunk = static_cast<uint32_t>(chunks.size() - 1);
+    location.row = static_cast<uint32_t>(chunk.count);
+
+    chunk.owners.push_back(owner);
+    ++chunk.count;
+    return location;
+}
+
+void Archetype::removeRow(const EntityLocation& location) {
+    // Компоненты строки уже перемещены или разрушены.
+    // На ее место переносим последний объект архетипа, чтобы блоки оставались плотными
+    size_t lastChunk = chunks.size() - 1;
+    size_t lastRow = chunks[lastChunk].count - 1;
+
+    if (location.chunk != lastChunk || location.row != lastRow) {
+        for (size_t column = 0; column < types.size(); ++column) {
+            types[column]->relocate(getComponent(location.chunk, column, location.row),
+                getComponent(lastChunk, column, lastRow));
+        }
+
+        EntityHandle movedHandle = chunks[lastChunk].owners[lastRow];
+        chunks[location.chunk].owners[location.row] = movedHandle;
+        if (GameObject* moved = EntityRegistry::getInstance().resolve(movedHandle)) {
+            moved->onStorageRelocated(location);
+        }
+    }
+
+    Chunk& chunk = chunks[lastChunk];
+    chunk.owners.pop_back();
+    if (--chunk.count == 0) {
+        ::operator delete(chunk.memory, std::align_val_t(ChunkAlignment));
+        chunks.pop_back();
+    }
+}
+
+// ==================== Поиск архетипов ====================
+Archetype* ArchetypeStorage::getArchetype(std::vector<const ComponentTypeInfo*> types) {
+    std::sort(types.begin(), types.end(), [](const ComponentTypeInfo* a, const ComponentTypeInfo* b) {
+        return a->type < b->type;
+        });
+
+    std::vector<std::type_index> key;
+    key.reserve(types.size());
+    for (const ComponentTypeInfo* type : types) {
+        key.push_back(type->type);
+    }
+
+    auto it = archetypes.find(key);
+    if (it != archetypes.end()) {
+        return it->second.get();
+    }
+
+    auto archetype = std::make_unique<Archetype>(std::move(types));
+    Archetype* ptr = archetype.get();
+    archetypes.emplace(std::move(key), std::move(archetype));
+    archetypeList.push_back(ptr);
+    return ptr;
+}
+
+Archetype* ArchetypeStorage::getArchetypeWith(Archetype* from, const ComponentTypeInfo* added) {
+    if (from) {
+        auto edge = from->addEdges.find(added->type);
+        if (edge != from->addEdges.end()) return edge->second;
+        if (from->has(added->type)) return from;
+    }
+
+    std::vector<const ComponentTypeInfo*> types;
+    if (from) types = from->getTypes();
+    types.push_back(added);
+
+    Archetype* result = getArchetype(std::move(types));
+    if (from) from->addEdges[added->type] = result;
+    return result;
+}
+
+Archetype* ArchetypeStorage::getArchetypeWithout(Archetype* from, std::type_index removed) {
+    auto edge = from->removeEdges.find(removed);
+    if (edge != from->removeEdges.end()) return edge->second;
+
+    std::vector<const ComponentTypeInfo*> types;
+    for (const ComponentTypeInfo* type : from->getTypes()) {
+        if (type->type != removed) types.push_back(type);
+    }
+
+    Archetype* result = getArchetype(std::move(types));
+    from->removeEdges[removed] = result;
+    return result;
+}
+
+// ==================== Объекты ====================
+EntityLocation ArchetypeStorage::move(const EntityLocation& from, Archetype* to, EntityHandle owner) {
+    EntityLocation target = to->allocateRow(owner);
+
+    Archetype* source = from.archetype;
+    if (!source) return target;
+
+    for (size_t column = 0; column < source->types.size(); ++column) {
+        const ComponentTypeInfo* type = source->types[column];
+        void* component = source->getComponent(from.chunk, column, from.row);
+
+        int targetColumn = to->findColumn(type->type);
+        if (targetColumn >= 0) {
+            type->relocate(to->getComponent(target.chunk, targetColumn, target.row), component);
+        }
+        else {
+            type->destroy(component);
+        }
+    }
+
+    // Строка в исходном архетипе занимается последним объектом (его владелец получит новое положение)
+    source->removeRow(from);
+    return target;
+}
+
+void ArchetypeStorage::release(const EntityLocation& location) {
+    Archetype* archetype = location.archetype;
+    if (!archetype) return;
+
+    for (size_t column = 0; column < archetype->types.size(); ++column) {
+        archetype->types[column]->destroy(archetype->getComponent(location.chunk, column, location.row));
+    }
+    archetype->removeRow(location);
+}
+
+bool ArchetypeStorage::allowMove(const EntityLocation& from, const std::string& objectName, const char* operation) const {
+    if (!from.archetype || !isLocked()) return true;
+
+    LOG_ERROR("Archetype: %s у объекта '%s' во время обхода отклонено - используйте CommandBuffer",
+        operation, objectName.c_str());
+    return false;
+}
+
+void* ArchetypeStorage::getComponent(const EntityLocation& location, std::type_index type) const {
+    if (!location.archetype) return nullptr;
+
+    int column = location.archetype->findColumn(type);
+    if (column < 0) return nullptr;
+    return location.archetype->getComponent(location.chunk, column, location.row);
+}
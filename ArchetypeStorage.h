@@ -0,0 +1,211 @@
+#pragma once
+#include "Component.h"
+#include "EntityHandle.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class GameObject;
+
+// ==================== Режим хранения компонентов ====================
+enum class ComponentStorage {
+    Heap,           // Каждый компонент - отдельный объект в куче (по умолчанию)
+    Archetype       // Компоненты в общих блоках архетипа (объекты с одинаковым набором компонентов).
+                    // Добавление и удаление компонента переносит все компоненты объекта (и последний
+                    // объект архетипа): во время обхода - только через CommandBuffer
+};
+
+// ==================== Описание типа компонента ====================
+// Операции над компонентом без знания его типа (для колонок архетипа)
+struct ComponentTypeInfo {
+    std::type_index type;
+    ComponentTypeId id;                                     // InvalidComponentTypeId, если тип не зарегистрирован
+    ComponentHooks hooks;                                   // Переопределенные хуки (getComponentHooks)
+    size_t size;
+    size_t alignment;
+    void (*relocate)(void* destination, void* source);     // Перемещение с разрушением источника
+    void (*destroy)(void* object);
+    Component* (*asComponent)(void* object);
+
+    template<typename T>
+    static const ComponentTypeInfo* get() {
+        static_assert(std::is_move_constructible_v<T>,
+            "Компонент в хранилище архетипов должен быть перемещаемым");
+
+        static const ComponentTypeInfo info{
+            typeid(T), getComponentTypeId<T>(), getComponentHooks<T>(), sizeof(T), alignof(T),
+            [](void* destination, void* source) {
+                T* object = static_cast<T*>(source);
+                ::new (destination) T(std::move(*object));
+                object->~T();
+            },
+            [](void* object) { static_cast<T*>(object)->~T(); },
+            [](void* object) -> Component* { return static_cast<T*>(object); }
+        };
+        return &info;
+    }
+};
+
+class Archetype;
+
+// ==================== Положение объекта в хранилище ====================
+struct EntityLocation {
+    Archetype* archetype = nullptr;
+    uint32_t chunk = 0;
+    uint32_t row = 0;
+};
+
+// ==================== Архетип ====================
+// Все объекты с одинаковым набором типов компонентов. Объекты лежат в блоках (chunk)
+// фиксированного размера; внутри блока у каждого типа своя непрерывная колонка (SoA):
+// все Transform блока подряд, затем все MeshRenderer и т.д.
+class Archetype {
+public:
+    static constexpr size_t ChunkBytes = 16 * 1024;    // Размер блока
+    static constexpr size_t ChunkAlignment = 64;       // Выравнивание блока (кэш-линия)
+
+    explicit Archetype(std::vector<const ComponentTypeInfo*> types);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    // ==================== Типы ====================
+    const std::vector<const ComponentTypeInfo*>& getTypes() const { return types; }
+    int findColumn(std::type_index type) const;
+    bool has(std::type_index type) const { return findColumn(type) >= 0; }
+
+    // ==================== Блоки ====================
+    size_t getChunkCapacity() const { return chunkCapacity; }
+    size_t getChunkCount() const { return chunks.size(); }
+    size_t getChunkSize(size_t chunk) const { return chunks[chunk].count; }
+    size_t getEntityCount() const;
+
+    // Начало колонки column в блоке chunk
+    void* getColumn(size_t chunk, size_t column) const {
+        return chunks[chunk].memory + columnOffsets[column];
+    }
+
+    // Компонент в строке row
+    void* getComponent(size_t chunk, size_t column, size_t row) const {
+        return chunks[chunk].memory + columnOffsets[column] + row * types[column]->size;
+    }
+
+    EntityHandle getOwner(size_t chunk, size_t row) const { return chunks[chunk].owners[row]; }
+
+private:
+    friend class ArchetypeStorage;
+
+    struct Chunk {
+        std::byte* memory = nullptr;
+        std::vector<EntityHandle> owners;
+        size_t count = 0;
+    };
+
+    EntityLocation allocateRow(EntityHandle owner);
+    void removeRow(const EntityLocation& location);
+
+    std::vector<const ComponentTypeInfo*> types;   // Отсортированы по type_index
+    std::vector<size_t> columnOffsets;
+    size_t chunkCapacity = 0;
+    size_t chunkBytes = 0;
+    std::vector<Chunk> chunks;
+
+    // Переходы при добавлении/удалении одного типа (кэш поиска архетипа)
+    std::unordered_map<std::type_index, Archetype*> addEdges;
+    std::unordered_map<std::type_index, Archetype*> removeEdges;
+};
+
+// ==================== Хранилище архетипов ====================
+// Общее хранилище компонентов всех объектов в режиме ComponentStorage::Archetype.
+// Структурные изменения (добавление/удаление компонентов и объектов) - только из одного потока.
+// Добавление компонента переносит компоненты объекта в другой архетип, а удаление объекта
+// переносит на освободившееся место последний объект архетипа, поэтому указатели на компоненты
+// в этом режиме действительны только до следующего структурного изменения.
+// Пока идет обход (Scene::update, системы SystemScheduler), хранилище заблокировано: перенос
+// любого объекта сдвинул бы строку другого объекта, компоненты которого сейчас работают
+class ArchetypeStorage {
+public:
+    static ArchetypeStorage& getInstance() {
+        static ArchetypeStorage instance;
+        return instance;
+    }
+
+    ArchetypeStorage(const ArchetypeStorage&) = delete;
+    ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+    // ==================== Архетипы ====================
+    Archetype* getArchetype(std::vector<const ComponentTypeInfo*> types);
+    Archetype* getArchetypeWith(Archetype* from, const ComponentTypeInfo* added);
+    Archetype* getArchetypeWithout(Archetype* from, std::type_index removed);
+    const std::vector<Archetype*>& getArchetypes() const { return archetypeList; }
+
+    // ==================== Объекты ====================
+    // Перенос объекта в архетип to. Общие компоненты перемещаются, отсутствующие в to - разрушаются,
+    // новые колонки остаются неинициализированными (их конструирует вызывающий)
+    EntityLocation move(const EntityLocation& from, Archetype* to, EntityHandle owner);
+
+    // Разрушение всех компонентов объекта и освобождение строки
+    void release(const EntityLocation& location);
+
+    void* getComponent(const EntityLocation& location, std::type_index type) const;
+
+    // ==================== Блокировка структурных изменений ====================
+    // Участок обхода, в котором переносы запрещены. Участки могут быть вложенными
+    class StructuralLock {
+    public:
+        StructuralLock() { ArchetypeStorage::getInstance().structuralLocks.fetch_add(1, std::memory_order_relaxed); }
+        ~StructuralLock() { ArchetypeStorage::getInstance().structuralLocks.fetch_sub(1, std::memory_order_relaxed); }
+
+        StructuralLock(const StructuralLock&) = delete;
+        StructuralLock& operator=(const StructuralLock&) = delete;
+    };
+
+    bool isLocked() const { return structuralLocks.load(std::memory_order_relaxed) != 0; }
+
+    // Можно ли перенести объект из from: хранилище не заблокировано, или объект еще не занимает строку
+    // (первый компонент нового объекта никого не сдвигает). Иначе - ошибка в лог, перенос отклоняется
+    bool allowMove(const EntityLocation& from, const std::string& objectName, const char* operation) const;
+
+    // ==================== Обход ====================
+    // func(T* components, size_t count) для каждого блока с компонентами T (непрерывный массив)
+    template<typename T, typename Func>
+    void forEachChunk(Func&& func) {
+        for (Archetype* archetype : archetypeList) {
+            int column = archetype->findColumn(typeid(T));
+            if (column < 0) continue;
+
+            for (size_t chunk = 0; chunk < archetype->getChunkCount(); ++chunk) {
+                T* components = std::launder(static_cast<T*>(archetype->getColumn(chunk, column)));
+                func(components, archetype->getChunkSize(chunk));
+            }
+        }
+    }
+
+    // func(T&) для каждого компонента T во всех архетипах
+    template<typename T, typename Func>
+    void forEach(Func&& func) {
+        forEachChunk<T>([&func](T* components, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                func(components[i]);
+            }
+            });
+    }
+
+private:
+    ArchetypeStorage() = default;
+
+    // Ключ архетипа - отсортированный набор типов
+    std::map<std::vector<std::type_index>, std::unique_ptr<Archetype>> archetypes;
+    std::vector<Archetype*> archetypeList;
+    std::atomic<int> structuralLocks{ 0 };                  // Открытые StructuralLock
+};
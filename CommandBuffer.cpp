@@ -0,0 +1,202 @@
+#include "CommandBuffer.h"
+#include "Scene.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+    // Буферы всех потоков (буфер потока регистрируется при создании)
+    std::mutex buffersMutex;
+
+    std::vector<CommandBuffer*>& getBuffers() {
+        static std::vector<CommandBuffer*> buffers;
+        return buffers;
+    }
+
+    // Ключ "объект + тип компонента" для сжатия пакета
+    struct ComponentKey {
+        uint64_t object;
+        std::type_index type;
+
+        bool operator==(const ComponentKey& other) const { return object == other.object && type == other.type; }
+    };
+
+    struct ComponentKeyHash {
+        size_t operator()(const ComponentKey& key) const {
+            return std::hash<uint64_t>()(key.object) ^ (std::hash<std::type_index>()(key.type) * 31);
+        }
+    };
+}
+
+// ==================== Буферы потоков ====================
+CommandBuffer::CommandBuffer() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    getBuffers().push_back(this);
+}
+
+CommandBuffer::~CommandBuffer() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    auto& buffers = getBuffers();
+    buffers.erase(std::remove(buffers.begin(), buffers.end(), this), buffers.end());
+}
+
+CommandBuffer& CommandBuffer::getThreadBuffer() {
+    thread_local CommandBuffer buffer;
+    return buffer;
+}
+
+// ==================== Запись команд ====================
+void CommandBuffer::createGameObject(Scene& scene, const std::string& name, EntityHandle parent,
+    std::function<void(GameObject&)> init) {
+    Command& command = push(CommandType::CreateObject, parent);
+    command.scene = &scene;
+    command.name = name;
+    command.apply = std::move(init);
+}
+
+void CommandBuffer::destroyGameObject(Scene& scene, EntityHandle handle) {
+    Command& command = push(CommandType::DestroyObject, handle);
+    command.scene = &scene;
+}
+
+void CommandBuffer::setParent(Scene& scene, EntityHandle child, EntityHandle newParent) {
+    Command& command = push(CommandType::SetParent, child);
+    command.scene = &scene;
+    command.parent = newParent;
+}
+
+// ==================== Воспроизведение ====================
+void CommandBuffer::playbackAll() {
+    // Пакет переиспользуется между кадрами (воспроизведение - только в основном потоке)
+    static std::vector<Command> batch;
+
+    // Команды, записанные во время воспроизведения (например, в start добавленного компонента),
+    // применяются следующим пакетом в том же вызове
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            for (CommandBuffer* buffer : getBuffers()) {
+                batch.insert(batch.end(),
+                    std::make_move_iterator(buffer->commands.begin()),
+                    std::make_move_iterator(buffer->commands.end()));
+                buffer->commands.clear();
+            }
+        }
+        if (batch.empty()) return;
+
+        PROFILE_SCOPE("CommandPlayback");
+        compact(batch);
+        execute(batch);
+        batch.clear();
+    }
+}
+
+void CommandBuffer::compact(std::vector<Command>& batch) {
+    // Объекты, уничтожаемые в этом пакете, вместе со всеми потомками: их команды компонентов
+    // и создание детей не нужны. Повторное уничтожение (в том числе внутри уже уничтожаемого
+    // поддерева) выполняется один раз
+    EntityRegistry& registry = EntityRegistry::getInstance();
+    std::unordered_set<uint64_t> destroyed;
+    std::vector<GameObject*> stack;
+    for (Command& command : batch) {
+        if (command.type != CommandType::DestroyObject) continue;
+        if (destroyed.count(command.target.toBits())) {
+            command.skipped = true;
+            continue;
+        }
+
+        GameObject* root = registry.resolve(command.target);
+        if (!root) continue;
+
+        stack.push_back(root);
+        while (!stack.empty()) {
+            GameObject* object = stack.back();
+            stack.pop_back();
+            destroyed.insert(object->getHandle().toBits());
+            for (const auto& child : object->getChildren()) {
+                stack.push_back(child.get());
+            }
+        }
+    }
+
+    // Обратный проход: команды компонента, за которыми следует удаление того же типа
+    // у того же объекта, ничего не меняют - итог определяет последнее удаление
+    std::unordered_set<ComponentKey, ComponentKeyHash> removedLater;
+    for (auto it = batch.rbegin(); it != batch.rend(); ++it) {
+        Command& command = *it;
+        switch (command.type) {
+        case CommandType::CreateObject:
+            if (!command.target.isNull() && destroyed.count(command.target.toBits())) {
+                command.skipped = true;
+            }
+            break;
+        case CommandType::SetParent:
+            // Перенос уничтожаемого объекта или под уничтожаемого родителя ничего не меняет
+            if (destroyed.count(command.target.toBits()) ||
+                (!command.parent.isNull() && destroyed.count(command.parent.toBits()))) {
+                command.skipped = true;
+            }
+            break;
+        case CommandType::AddComponent:
+        case CommandType::RemoveComponent: {
+            uint64_t object = command.target.toBits();
+            if (destroyed.count(object)) {
+                command.skipped = true;
+                break;
+            }
+
+            ComponentKey key{ object, command.componentType };
+            if (removedLater.count(key)) {
+                command.skipped = true;
+            }
+            else if (command.type == CommandType::RemoveComponent) {
+                removedLater.insert(key);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+void CommandBuffer::execute(std::vector<Command>& batch) {
+    // Создание, затем смена родителя и изменения компонентов в порядке записи, уничтожение - последним
+    for (Command& command : batch) {
+        if (command.skipped || command.type != CommandType::CreateObject) continue;
+
+        Scene& scene = *command.scene;
+        EntityHandle handle = command.target.isNull()
+            ? scene.createGameObject(command.name)
+            : scene.createGameObject(command.name, command.target);
+        if (command.apply) {
+            command.apply(*scene.resolve(handle));
+        }
+    }
+
+    EntityRegistry& registry = EntityRegistry::getInstance();
+    for (Command& command : batch) {
+        if (command.skipped) continue;
+
+        if (command.type == CommandType::AddComponent) {
+            if (GameObject* object = registry.resolve(command.target)) {
+                command.apply(*object);
+            }
+        }
+        else if (command.type == CommandType::RemoveComponent) {
+            if (GameObject* object = registry.resolve(command.target)) {
+                object->removeComponent(command.componentType, command.componentId);
+            }
+        }
+        else if (command.type == CommandType::SetParent) {
+            command.scene->setParent(command.target, command.parent);
+        }
+    }
+
+    for (Command& command : batch) {
+        if (command.skipped || command.type != CommandType::DestroyObject) continue;
+        command.scene->destroyGameObject(command.target);
+    }
+}
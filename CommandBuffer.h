@@ -0,0 +1,96 @@
+#pragma once
+#include "GameObject.h"
+#include <functional>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+class Scene;
+
+// ==================== Буфер отложенных структурных изменений ====================
+// Создание и уничтожение объектов, смена родителя, добавление и удаление компонентов во время обхода
+// (GameObject::update, системы на рабочих потоках) меняют те самые массивы, по которым идет обход.
+// Такие изменения записываются в буфер своего потока и применяются одним пакетом в точке
+// синхронизации (CommandBuffer::playbackAll: конец Scene::update, после систем в SystemScheduler).
+// Scene::destroyGameObject и Scene::setParent во время обхода пишут сюда сами, Scene::createGameObject -
+// в фазе систем (с пустым дескриптором в ответ).
+// При воспроизведении команды объектов, уничтожаемых в том же пакете, отбрасываются, повторное
+// уничтожение выполняется один раз, добавление компонента, который позже удаляется, не выполняется
+class CommandBuffer {
+public:
+    CommandBuffer();
+    ~CommandBuffer();
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    // Буфер текущего потока (создается при первом обращении)
+    static CommandBuffer& getThreadBuffer();
+
+    // Применение команд всех потоков. Вызывается из основного потока, когда другие потоки
+    // не записывают команды (после ожидания заданий)
+    static void playbackAll();
+
+    // ==================== Запись команд ====================
+
+    // Объект создается при воспроизведении; init (если задан) настраивает его сразу после создания
+    void createGameObject(Scene& scene, const std::string& name, EntityHandle parent = EntityHandle(),
+        std::function<void(GameObject&)> init = {});
+
+    void destroyGameObject(Scene& scene, EntityHandle handle);
+
+    // Смена родителя (пустой newParent - корневой объект); проверки Scene::setParent - при воспроизведении
+    void setParent(Scene& scene, EntityHandle child, EntityHandle newParent);
+
+    template<typename T, typename... Args>
+    void addComponent(EntityHandle target, Args... args) {
+        static_assert(std::is_base_of<Component, T>::value, "T должен наследоваться от Component");
+
+        Command& command = push(CommandType::AddComponent, target);
+        command.componentType = typeid(T);
+        command.apply = [args...](GameObject& object) { object.addComponent<T>(args...); };
+    }
+
+    template<typename T>
+    void removeComponent(EntityHandle target) {
+        Command& command = push(CommandType::RemoveComponent, target);
+        command.componentType = typeid(T);
+        command.componentId = getComponentTypeId<T>();
+    }
+
+    size_t size() const { return commands.size(); }
+    bool empty() const { return commands.empty(); }
+
+private:
+    enum class CommandType {
+        CreateObject,
+        DestroyObject,
+        SetParent,
+        AddComponent,
+        RemoveComponent
+    };
+
+    struct Command {
+        CommandType type;
+        EntityHandle target;                        // Для CreateObject - родитель
+        EntityHandle parent;                        // SetParent - новый родитель
+        Scene* scene = nullptr;                     // CreateObject, DestroyObject, SetParent
+        std::type_index componentType = typeid(void);
+        ComponentTypeId componentId = InvalidComponentTypeId;
+        std::string name;                           // CreateObject
+        std::function<void(GameObject&)> apply;     // AddComponent, инициализация для CreateObject
+        bool skipped = false;                       // Отброшена при сжатии пакета
+    };
+
+    Command& push(CommandType type, EntityHandle target) {
+        Command& command = commands.emplace_back();
+        command.type = type;
+        command.target = target;
+        return command;
+    }
+
+    static void compact(std::vector<Command>& batch);
+    static void execute(std::vector<Command>& batch);
+
+    std::vector<Command> commands;
+};
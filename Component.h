@@ -1,8 +1,58 @@
 #pragma once
+#include "SlabPool.h"
+#include "EntityHandle.h"
 #include <string>
 #include <memory>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
 
 class GameObject;
+struct FrameSnapshot;
+
+// ==================== Идентификаторы типов компонентов ====================
+// Типы, зарегистрированные через REGISTER_COMPONENT, получают плотный номер 0..MaxComponentTypes-1
+// при первом обращении. Номера зависят от порядка использования и не сохраняются между запусками
+using ComponentTypeId = uint32_t;
+using ComponentMask = uint64_t;     // Бит N - у объекта есть компонент с номером N
+
+constexpr ComponentTypeId MaxComponentTypes = 64;
+constexpr ComponentTypeId InvalidComponentTypeId = ~0u;
+
+inline ComponentTypeId allocateComponentTypeId() {
+    static std::atomic<ComponentTypeId> nextId{ 0 };
+    ComponentTypeId id = nextId.fetch_add(1, std::memory_order_relaxed);
+    // Типы сверх лимита остаются без номера и ищутся через type_index
+    return id < MaxComponentTypes ? id : InvalidComponentTypeId;
+}
+
+// Тип зарегистрирован сам (а не унаследовал регистрацию базового класса)
+template<typename T>
+constexpr bool isRegisteredComponent = requires {
+    requires std::is_same_v<typename T::RegisteredComponentType, T>;
+};
+
+// Номер типа компонента (InvalidComponentTypeId для незарегистрированных типов)
+template<typename T>
+ComponentTypeId getComponentTypeId() {
+    if constexpr (isRegisteredComponent<T>) {
+        static const ComponentTypeId id = allocateComponentTypeId();
+        return id;
+    }
+    else {
+        return InvalidComponentTypeId;
+    }
+}
+
+// Бит типа компонента в ComponentMask. Типы без номера (сверх MaxComponentTypes) получают
+// все биты: планировщик считает такие системы пересекающимися со всеми и выполняет
+// последовательно, а запросу сцены с таким типом не соответствует ни один объект
+template<typename T>
+ComponentMask getComponentBit() {
+    static_assert(isRegisteredComponent<T>, "Маски есть только у типов из REGISTER_COMPONENT");
+    ComponentTypeId id = getComponentTypeId<T>();
+    return id != InvalidComponentTypeId ? ComponentMask(1) << id : ~ComponentMask(0);
+}
 
 class Component {
 public:
@@ -11,6 +61,7 @@ public:
     virtual void start() {}
     virtual void update(float deltaTime) {}
     virtual void render() {}
+    virtual void submit(FrameSnapshot& frame) {}  // Передача данных рендеринга в снимок кадра
     virtual void onDestroy() {}
 
     // Serialization
@@ -19,18 +70,43 @@ public:
     virtual void deserialize(std::istream& is) {}
 
     // Getters
-    GameObject* getGameObject() const { return gameObject; }
-    void setGameObject(GameObject* obj) { gameObject = obj; }
+    // Объект-владелец (nullptr, если он уже уничтожен)
+    GameObject* getGameObject() const { return EntityRegistry::getInstance().resolve(owner); }
+    EntityHandle getOwner() const { return owner; }
+    void setOwner(EntityHandle handle) { owner = handle; }
 
     bool isEnabled() const { return enabled; }
     void setEnabled(bool enable) { enabled = enable; }
 
 protected:
-    GameObject* gameObject = nullptr;
+    EntityHandle owner;     // Дескриптор владельца (не зависит от адреса GameObject)
     bool enabled = true;
 };
 
-// Макрос для регистрации компонентов
+// ==================== Переопределенные хуки ====================
+// Какие методы жизненного цикла переопределяет тип. &T::update имеет тип void (Component::*)(float),
+// только если ни T, ни его базовые классы не объявили свой update - такой компонент
+// не нужно вызывать каждый кадр (например, Transform и компоненты-данные)
+using ComponentHooks = uint8_t;
+
+constexpr ComponentHooks HookUpdate = 1 << 0;
+constexpr ComponentHooks HookRender = 1 << 1;
+constexpr ComponentHooks HookSubmit = 1 << 2;
+
+template<typename T>
+constexpr ComponentHooks getComponentHooks() {
+    ComponentHooks hooks = 0;
+    if constexpr (!std::is_same_v<decltype(&T::update), void (Component::*)(float)>) hooks |= HookUpdate;
+    if constexpr (!std::is_same_v<decltype(&T::render), void (Component::*)()>) hooks |= HookRender;
+    if constexpr (!std::is_same_v<decltype(&T::submit), void (Component::*)(FrameSnapshot&)>) hooks |= HookSubmit;
+    return hooks;
+}
+
+// Макрос для регистрации компонентов (компоненты типа выделяются из ObjectPool<TYPE>)
 #define REGISTER_COMPONENT(TYPE) \
+    DECLARE_POOLED_ALLOCATION(TYPE) \
+    using RegisteredComponentType = TYPE; \
     static std::string getStaticTypeName() { return #TYPE; } \
-    virtual std::string getTypeName() const override { return #TYPE; }
\ No newline at end of file
+    static ComponentTypeId getStaticTypeId() { return getComponentTypeId<TYPE>(); } \
+    static constexpr ComponentHooks getStaticHooks() { return getComponentHooks<TYPE>(); } \
+    virtual std::string getTypeName() const override { return #TYPE; }
@@ -1,9 +1,18 @@
 ﻿#include "Core.h"
 #include "GameObject.h"
 #include "Shader.h"
+#include "JobSystem.h"
+#include "SystemScheduler.h"
+#include "TransformBatch.h"
+#include "MeshRenderer.h"
+#include "InputRecorder.h"
+#include "Profiler.h"
+#include "GpuProfiler.h"
+#include "FrameArena.h"
 #include <iostream>
 #include <windows.h> 
 #include <chrono>
+#include <cstdio>
 #include <thread>
 
 // ==================== Вспомогательные функции ====================
@@ -22,6 +31,11 @@ namespace CoreUtils {
 Core::Core() {
     // Создаем логгер
     logger = LogManager::getInstance().createConsoleLogger("Core");
+    inputRecorder = std::make_unique<InputRecorder>();
+    inputBatch.resize(InputEventQueue::capacity());
+
+    // Профилировщик создается раньше Core и переживает его (shutdown из деструктора)
+    Profiler::getInstance();
 }
 
 // ==================== Деструктор Core ====================
@@ -40,16 +54,75 @@ bool Core::initialize(const Config& config) {
     this->config = config;
     logger->setLevel(config.logLevel);
 
+    Profiler::setEnabled(config.profiling);
+    Profiler::getInstance().setThreadName("Главный поток");
+    if (config.traceCaptureFrameCount > 0) {
+        captureTraceFrames(config.traceCapturePath, config.traceCaptureFirstFrame,
+            config.traceCaptureFrameCount);
+    }
+
     LOG_INFO("Инициализация движка...");
     LOG_INFO("Конфигурация: %dx%d, заголовок: %s",
         config.width, config.height, config.title.c_str());
 
+    // Создание окна и контекста OpenGL (в безграфическом режиме пропускается)
+    if (config.headless == HeadlessMode::NoGraphics) {
+        LOG_INFO("Безграфический режим: окно и OpenGL не создаются");
+    }
+    else if (!initializeGraphics()) {
+        return false;
+    }
+
+    camera = new Camera();
+    camera->setPosition(glm::vec3(0.0f, 0.0f, 5.0f));
+    LOG_DEBUG("Камера создана и инициализирована");
+
+    // Инициализация менеджера шейдеров
+    shaderManager = std::make_unique<ShaderManager>();
+
+    // Настройка многопоточности
+    if (config.multithreaded) {
+        multithreadingEnabled = true;
+        unsigned int workerCount = config.maxThreads > 0
+            ? static_cast<unsigned int>(config.maxThreads)
+            : JobSystem::getDefaultWorkerCount();
+        jobSystem = std::make_unique<JobSystem>(workerCount);
+        LOG_INFO("Многопоточность включена (%u рабочих потоков)", workerCount);
+    }
+    else {
+        // Без рабочих потоков задания выполняет ожидающий поток
+        jobSystem = std::make_unique<JobSystem>(0);
+        LOG_INFO("Многопоточность выключена");
+    }
+    systemScheduler = std::make_unique<SystemScheduler>(jobSystem.get());
+    LOG_INFO("Пакетная сборка матриц: %s", getTransformBatchPathName(getTransformBatchPath()));
+
+    // Без OpenGL рендерить нечего - конвейер не нужен
+    pipelineEnabled = config.pipelinedRendering && window != nullptr;
+    LOG_INFO("Конвейерный рендеринг: %s", pipelineEnabled ? "включен" : "выключен");
+
+    initialized = true;
+    LOG_INFO("Движок успешно инициализирован!");
+    return true;
+}
+
+// ==================== Создание окна и контекста OpenGL ====================
+bool Core::initializeGraphics() {
+    bool offscreen = config.headless == HeadlessMode::Offscreen;
+
+    // Без дисплея используем null-платформу GLFW: контекст создается через EGL
+    // (surfaceless/pbuffer, работает с программным растеризатором Mesa)
+    if (offscreen) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+
     // Инициализация GLFW
     if (!glfwInit()) {
         LOG_ERROR("Не удалось инициализировать GLFW");
         return false;
     }
 
+    glfwInitialized = true;
     LOG_DEBUG("GLFW инициализирован");
 
     // Настройка GLFW
@@ -62,6 +135,11 @@ bool Core::initialize(const Config& config) {
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
 #endif
 
+    if (offscreen) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    }
+
     // Создание окна
     window = glfwCreateWindow(
         config.width,
@@ -71,13 +149,22 @@ bool Core::initialize(const Config& config) {
         nullptr
     );
 
+    // Если EGL недоступен, пробуем программный контекст OSMesa
+    if (!window && offscreen) {
+        LOG_WARNING("Не удалось создать контекст EGL, пробуем OSMesa");
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        window = glfwCreateWindow(config.width, config.height, config.title.c_str(), nullptr, nullptr);
+    }
+
     if (!window) {
         LOG_ERROR("Не удалось создать окно GLFW");
         glfwTerminate();
+        glfwInitialized = false;
         return false;
     }
 
-    LOG_INFO("Окно создано: %dx%d", config.width, config.height);
+    LOG_INFO(offscreen ? "Внеэкранный контекст создан: %dx%d" : "Окно создано: %dx%d",
+        config.width, config.height);
 
     // Настройка контекста OpenGL
     glfwMakeContextCurrent(window);
@@ -99,12 +186,24 @@ bool Core::initialize(const Config& config) {
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         LOG_ERROR("Не удалось инициализировать GLAD");
         glfwDestroyWindow(window);
+        window = nullptr;
         glfwTerminate();
+        glfwInitialized = false;
         return false;
     }
 
     LOG_DEBUG("GLAD инициализирован");
 
+    // Внеэкранный режим рисует в собственный framebuffer
+    if (offscreen && !createOffscreenTarget()) {
+        LOG_ERROR("Не удалось создать внеэкранный framebuffer");
+        glfwDestroyWindow(window);
+        window = nullptr;
+        glfwTerminate();
+        glfwInitialized = false;
+        return false;
+    }
+
     // Настройка OpenGL
     glViewport(0, 0, config.width, config.height);
     glClearColor(
@@ -123,48 +222,77 @@ bool Core::initialize(const Config& config) {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     LOG_DEBUG("Смешивание цветов включено");
 
-    camera = new Camera();
-    camera->setPosition(glm::vec3(0.0f, 0.0f, 5.0f));
-    LOG_DEBUG("Камера создана и инициализирована");
-
-
     // Вывод информации о OpenGL
     CoreUtils::printGLInfo();
 
-    // Инициализация менеджера шейдеров
-    shaderManager = std::make_unique<ShaderManager>();
-
-    // Настройка многопоточности
-    if (config.multithreaded) {
-        multithreadingEnabled = true;
-        LOG_INFO("Многопоточность включена (%d потоков)", config.maxThreads);
-
-        // Создаем рабочие потоки
-        for (int i = 0; i < config.maxThreads; ++i) {
-            if (i == 0) {
-                // Первый поток для обновления
-                workerThreads.emplace_back(&Core::updateThreadFunction, this);
-                LOG_DEBUG("Создан поток обновления #%d", i);
-            }
-            else {
-                // Остальные потоки для рендеринга
-                workerThreads.emplace_back(&Core::renderThreadFunction, this);
-                LOG_DEBUG("Создан поток рендеринга #%d", i);
-            }
+    // Таймеры GPU (без поддержки OpenGL 3.3 профилирование GPU просто отключается)
+    if (config.gpuProfiling) {
+        gpuProfiler = std::make_unique<GpuProfiler>();
+        if (!gpuProfiler->initialize()) {
+            gpuProfiler.reset();
         }
     }
-    else {
-        LOG_INFO("Многопоточность выключена");
+    return true;
+}
+
+// ==================== Внеэкранный framebuffer ====================
+bool Core::createOffscreenTarget() {
+    glGenFramebuffers(1, &offscreenFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, offscreenFramebuffer);
+
+    // Цвет
+    glGenRenderbuffers(1, &offscreenColorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, offscreenColorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, config.width, config.height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreenColorBuffer);
+
+    // Глубина и трафарет
+    glGenRenderbuffers(1, &offscreenDepthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, offscreenDepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, config.width, config.height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, offscreenDepthBuffer);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        destroyOffscreenTarget();
+        return false;
     }
 
-    initialized = true;
-    LOG_INFO("Движок успешно инициализирован!");
+    // Framebuffer остается привязанным: все кадры рисуются в него
+    LOG_DEBUG("Внеэкранный framebuffer создан: %dx%d", config.width, config.height);
+    return true;
+}
+
+void Core::destroyOffscreenTarget() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (offscreenDepthBuffer) glDeleteRenderbuffers(1, &offscreenDepthBuffer);
+    if (offscreenColorBuffer) glDeleteRenderbuffers(1, &offscreenColorBuffer);
+    if (offscreenFramebuffer) glDeleteFramebuffers(1, &offscreenFramebuffer);
+    offscreenDepthBuffer = 0;
+    offscreenColorBuffer = 0;
+    offscreenFramebuffer = 0;
+}
+
+// ==================== Чтение внеэкранного кадра ====================
+bool Core::readFramebuffer(std::vector<unsigned char>& pixels) {
+    if (!window) return false;
+
+    // Контекст должен принадлежать вызывающему потоку
+    if (renderThread.joinable()) {
+        LOG_WARNING("readFramebuffer недоступен в конвейерном режиме - используйте enqueueRenderTask");
+        return false;
+    }
+
+    pixels.resize(static_cast<size_t>(config.width) * config.height * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, config.width, config.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
     return true;
 }
 
 // ==================== Запуск главного цикла ====================
 void Core::run() {
-    if (!initialized || !window) {
+    if (!initialized || (!window && config.headless != HeadlessMode::NoGraphics)) {
         LOG_ERROR("Движок не инициализирован!");
         return;
     }
@@ -172,6 +300,8 @@ void Core::run() {
     LOG_INFO("Запуск главного цикла...");
     running = true;
 
+    beginFrameLoop();
+
     // Используем high_resolution_clock для точного времени
     using Clock = std::chrono::high_resolution_clock;
     auto lastTime = Clock::now();
@@ -183,7 +313,7 @@ void Core::run() {
     float fps = 0.0f;
 
     // ==================== Главный игровой цикл ====================
-    while (running && !glfwWindowShouldClose(window)) {
+    while (running && !(window && glfwWindowShouldClose(window))) {
         // ТОЧНОЕ вычисление deltaTime
         auto currentTime = Clock::now();
         std::chrono::duration<float> elapsed = currentTime - lastTime;
@@ -210,137 +340,346 @@ void Core::run() {
             frameCount = 0;
             fpsTimer = 0.0f;
 
-            // Выводим FPS в заголовок окна
-            std::string newTitle = config.title +
-                " | FPS: " + std::to_string(static_cast<int>(fps)) +
-                " | Delta: " + std::to_string(deltaTime * 1000.0f).substr(0, 6) + " ms";
-            glfwSetWindowTitle(window, newTitle.c_str());
+            // Выводим FPS в заголовок окна (строка собирается в буфере на стеке)
+            if (window && config.headless == HeadlessMode::None) {
+                char newTitle[256];
+                std::snprintf(newTitle, sizeof(newTitle), "%s | FPS: %d | Delta: %.3f ms",
+                    config.title.c_str(), static_cast<int>(fps), deltaTime * 1000.0f);
+                glfwSetWindowTitle(window, newTitle);
+            }
 
             LOG_TRACE("FPS: %.1f, DeltaTime: %.3f ms", fps, deltaTime * 1000.0f);
+            PROFILE_COUNTER("FPS", fps);
         }
 
-        // Обработка ввода
+        // Сбор событий ввода (при воспроизведении журнала живой ввод игнорируется)
+        if (window) {
+            glfwPollEvents();
+        }
+
+        tickFrame(deltaTime, false);
+    }
+
+    endFrameLoop();
+
+    LOG_INFO("Главный цикл завершен");
+    shutdown();
+}
+
+// ==================== Пошаговое выполнение ====================
+void Core::stepFrames(unsigned int frameCount, float fixedDeltaTime) {
+    if (!initialized || (!window && config.headless != HeadlessMode::NoGraphics)) {
+        LOG_ERROR("Движок не инициализирован!");
+        return;
+    }
+
+    LOG_DEBUG("Пошаговое выполнение: %u кадров по %.3f мс", frameCount, fixedDeltaTime * 1000.0f);
+    running = true;
+    beginFrameLoop();
+
+    // Время кадра фиксировано, живой ввод не опрашивается - результат зависит
+    // только от начального состояния и журнала ввода
+    for (unsigned int i = 0; i < frameCount && running; ++i) {
+        tickFrame(fixedDeltaTime, true);
+    }
+
+    endFrameLoop();
+    running = false;
+}
+
+// ==================== Запуск и остановка цикла кадров ====================
+void Core::beginFrameLoop() {
+    // Запуск потока рендеринга: контекст OpenGL переходит к нему
+    if (pipelineEnabled) {
+        framePipeline.reset();
+        glfwMakeContextCurrent(nullptr);
+        renderThread = std::thread(&Core::renderThreadFunction, this);
+        LOG_INFO("Поток рендеринга запущен");
+    }
+}
+
+void Core::endFrameLoop() {
+    // Остановка потока рендеринга и возврат контекста главному потоку
+    if (renderThread.joinable()) {
+        framePipeline.stop();
+        renderThread.join();
+        glfwMakeContextCurrent(window);
+        LOG_INFO("Поток рендеринга остановлен");
+    }
+}
+
+// ==================== Один кадр движка ====================
+void Core::tickFrame(float deltaTime, bool singleStep) {
+    // Временная память прошлого кадра больше не используется
+    FrameArena::beginFrame();
+
+    // Зоны кадра закрываются до сбора статистики профилировщика
+    {
+        PROFILE_SCOPE("Frame");
+        simulateFrame(deltaTime, singleStep);
+    }
+
+    Profiler::getInstance().endFrame(frameIndex);
+    ++frameIndex;
+}
+
+void Core::simulateFrame(float deltaTime, bool singleStep) {
+    // Сохраняем для доступа извне
+    this->deltaTime = deltaTime;
+
+    // События ввода этого кадра (живые или из журнала)
+    {
+        PROFILE_SCOPE("Input");
+        pumpInput();
         processInput();
-        glfwPollEvents();
+    }
 
-        // Обновление состояния
-        if (multithreadingEnabled) {
-            // ... многопоточный код ...
+    if (singleStep || config.tickRate <= 0) {
+        // Один шаг на кадр
+        simulate(deltaTime);
+        interpolationAlpha = 1.0f;
+    }
+    else {
+        // Фиксированный шаг: симуляция идет с частотой tickRate независимо от частоты кадров
+        const double step = 1.0 / config.tickRate;
+        simulationAccumulator += deltaTime;
+
+        int steps = 0;
+        while (simulationAccumulator >= step && steps < config.maxCatchUpSteps) {
+            simulate(static_cast<float>(step));
+            simulationAccumulator -= step;
+            ++steps;
         }
-        else {
-            // Последовательное обновление
-            if (updateCallbackFunc) {
-                updateCallbackFunc(deltaTime);
-            }
 
-            // Последовательный рендеринг
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // Не догоняем бесконечно: лишнее время отбрасываем, чтобы медленные кадры не накапливались
+        if (simulationAccumulator >= step) {
+            LOG_DEBUG("Симуляция отстает: отброшено %.3f мс", simulationAccumulator * 1000.0);
+            simulationAccumulator = 0.0;
+        }
+
+        interpolationAlpha = static_cast<float>(simulationAccumulator / step);
+    }
+
+    if (!window) {
+        // Безграфический режим: только симуляция
+    }
+    else if (pipelineEnabled) {
+        // Передаем снимок кадра потоку рендеринга и сразу переходим к следующему кадру
+        submitFrame();
+    }
+    else {
+        // Связь симуляции и рендеринга кадра в трассе
+        PROFILE_FLOW_BEGIN("Frame", frameIndex);
+        renderFrame();
+
+        // Обмен буферов (внеэкранному framebuffer'у показ не нужен)
+        if (config.headless == HeadlessMode::None) {
+            PROFILE_SCOPE("SwapBuffers");
+            glfwSwapBuffers(window);
+        }
+    }
+}
+
+// ==================== Шаг симуляции ====================
+void Core::simulate(float deltaTime) {
+    PROFILE_SCOPE("Update");
 
-            // Устанавливаем цвет очистки
-            glClearColor(config.clearColor.r, config.clearColor.g,
-                config.clearColor.b, config.clearColor.a);
+    // Тяжелую работу callback распределяет через getJobSystem()
+    if (updateCallbackFunc) {
+        updateCallbackFunc(deltaTime);
+    }
+}
 
-            // Настройки OpenGL
-            glEnable(GL_DEPTH_TEST);
-            glDepthFunc(GL_LESS);
+// ==================== Последовательный рендеринг кадра ====================
+void Core::renderFrame() {
+    PROFILE_SCOPE("Render");
+    PROFILE_FLOW_END("Frame", frameIndex);
 
-            // Вызываем все рендер-коллбэки
-            for (auto& callback : renderCallbacks) {
-                callback();
-            }
+    if (gpuProfiler) gpuProfiler->beginFrame();
+    {
+        GPU_PROFILE_SCOPE(gpuProfiler.get(), "Frame");
 
-            // Проверка ошибок OpenGL
-            GL_CHECK();
+        {
+            GPU_PROFILE_SCOPE(gpuProfiler.get(), "Clear");
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         }
 
-        // Обмен буферов
-        glfwSwapBuffers(window);
-    }
+        // Устанавливаем цвет очистки
+        glClearColor(config.clearColor.r, config.clearColor.g,
+            config.clearColor.b, config.clearColor.a);
 
-    // Остановка потоков
-    if (multithreadingEnabled) {
-        LOG_INFO("Остановка рабочих потоков...");
-        stopThreads = true;
-        renderCV.notify_all();
+        // Настройки OpenGL
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LESS);
 
-        for (auto& thread : workerThreads) {
-            if (thread.joinable()) {
-                thread.join();
-            }
+        // Вызываем все рендер-коллбэки
+        for (auto& callback : renderCallbacks) {
+            GPU_PROFILE_SCOPE(gpuProfiler.get(), "RenderCallback");
+            callback();
         }
-        workerThreads.clear();
-        LOG_INFO("Все потоки остановлены");
     }
+    if (gpuProfiler) gpuProfiler->endFrame();
 
-    LOG_INFO("Главный цикл завершен");
-    shutdown();
+    // Счетчик сбрасывается каждый кадр, даже без записи трассы: иначе первый отсчет
+    // записи содержал бы все вызовы с момента запуска
+    unsigned int drawCalls = Mesh::takeDrawCallCount();
+    PROFILE_COUNTER("DrawCalls", drawCalls);
+
+    // Проверка ошибок OpenGL
+    GL_CHECK();
 }
 
-// ==================== Функция потока обновления ====================
-void Core::updateThreadFunction() {
-    LOG_DEBUG("Поток обновления запущен");
+// ==================== Заполнение снимка кадра (поток симуляции) ====================
+void Core::submitFrame() {
+    PROFILE_SCOPE("Submit");
 
-    while (!stopThreads) {
-        std::unique_lock<std::mutex> lock(renderMutex);
-        renderCV.wait(lock, [this]() {
-            return updateReady.load() || stopThreads.load();
-            });
+    FrameSnapshot* frame;
+    {
+        // Ожидание освобождения буфера потоком рендеринга
+        PROFILE_SCOPE("WaitRenderThread");
+        frame = framePipeline.beginWrite();
+    }
+    if (!frame) return;
 
-        if (stopThreads) break;
+    frame->clearColor = config.clearColor;
+    frame->viewportWidth = static_cast<int>(config.width);
+    frame->viewportHeight = static_cast<int>(config.height);
 
-        // Выполняем обновление
-        if (updateCallbackFunc) {
-            updateCallbackFunc(deltaTime);
-        }
+    if (camera) {
+        float aspectRatio = config.height > 0
+            ? static_cast<float>(config.width) / static_cast<float>(config.height)
+            : 1.0f;
+        frame->view = camera->getViewMatrix();
+        frame->projection = camera->getProjectionMatrix(aspectRatio);
+        frame->viewPosition = camera->getPosition();
+    }
 
-        updateReady = false;
-        renderReady = true;
-        renderCV.notify_one();
+    for (auto& callback : snapshotCallbacks) {
+        callback(*frame);
     }
 
-    LOG_DEBUG("Поток обновления завершен");
+    // Связь с отрисовкой этого снимка в потоке рендеринга
+    PROFILE_FLOW_BEGIN("Frame", frame->frameIndex);
+    framePipeline.publish();
+}
+
+// ==================== Отрисовка снимка кадра (поток рендеринга) ====================
+void Core::drawSnapshot(const FrameSnapshot& frame) {
+    PROFILE_SCOPE("DrawSnapshot");
+
+    if (frame.viewportWidth != appliedViewportWidth || frame.viewportHeight != appliedViewportHeight) {
+        glViewport(0, 0, frame.viewportWidth, frame.viewportHeight);
+        appliedViewportWidth = frame.viewportWidth;
+        appliedViewportHeight = frame.viewportHeight;
+    }
+
+    glClearColor(frame.clearColor.r, frame.clearColor.g,
+        frame.clearColor.b, frame.clearColor.a);
+    {
+        GPU_PROFILE_SCOPE(gpuProfiler.get(), "Clear");
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+
+    GPU_PROFILE_SCOPE(gpuProfiler.get(), "DrawSnapshot");
+
+    // Матрицы вида и проекции выставляем один раз на каждую смену шейдера
+    ShaderProgram* currentShader = nullptr;
+    for (const RenderItem& item : frame.items) {
+        if (!item.mesh || !item.shader) continue;
+
+        if (item.shader != currentShader) {
+            currentShader = item.shader;
+            currentShader->use();
+            currentShader->setMat4("view", frame.view);
+            currentShader->setMat4("projection", frame.projection);
+        }
+
+        currentShader->setMat4("model", item.model);
+        if (currentShader->hasUniform("normalMatrix")) {
+            currentShader->setMat3("normalMatrix", item.normal);
+        }
+        item.mesh->render();
+    }
 }
 
 // ==================== Функция потока рендеринга ====================
 void Core::renderThreadFunction() {
-    LOG_DEBUG("Поток рендеринга запущен");
+    Profiler::getInstance().setThreadName("Поток рендеринга");
+    glfwMakeContextCurrent(window);
+    LOG_DEBUG("Поток рендеринга получил контекст OpenGL");
+
+    // Viewport будет выставлен по первому снимку
+    appliedViewportWidth = 0;
+    appliedViewportHeight = 0;
+
+    while (const FrameSnapshot* frame = framePipeline.acquire()) {
+        {
+            PROFILE_SCOPE("RenderFrame");
+            PROFILE_FLOW_END("Frame", frame->frameIndex);
+            executeRenderTasks();
+
+            if (gpuProfiler) gpuProfiler->beginFrame();
+            {
+                GPU_PROFILE_SCOPE(gpuProfiler.get(), "Frame");
+                drawSnapshot(*frame);
+
+                // Рендер-коллбэки (только GL-состояние, без доступа к данным симуляции)
+                PROFILE_SCOPE("RenderCallbacks");
+                for (auto& callback : renderCallbacks) {
+                    GPU_PROFILE_SCOPE(gpuProfiler.get(), "RenderCallback");
+                    callback();
+                }
+            }
+            if (gpuProfiler) gpuProfiler->endFrame();
 
-    while (!stopThreads) {
-        std::unique_lock<std::mutex> lock(renderMutex);
-        renderCV.wait(lock, [this]() {
-            return renderReady.load() || stopThreads.load();
-            });
+            unsigned int drawCalls = Mesh::takeDrawCallCount();    // Каждый кадр (см. renderFrame)
+            PROFILE_COUNTER("DrawCalls", drawCalls);
+            GL_CHECK();
+
+            if (config.headless == HeadlessMode::None) {
+                PROFILE_SCOPE("SwapBuffers");
+                glfwSwapBuffers(window);
+            }
+        }
+        framePipeline.release();
+    }
 
-        if (stopThreads) break;
+    // Задачи, поставленные после последнего кадра (освобождение ресурсов)
+    executeRenderTasks();
 
-        // Выполняем рендеринг
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glfwMakeContextCurrent(nullptr);
+    LOG_DEBUG("Поток рендеринга завершен");
+}
 
-        GL_CHECK();
+// ==================== Задачи потока рендеринга ====================
+void Core::executeRenderTasks() {
+    // Быстрая проверка без блокировки - на обычном кадре задач нет
+    if (!hasRenderTasks.load(std::memory_order_acquire)) return;
 
-        renderReady = true;
-        renderCV.notify_one();
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(renderTaskMutex);
+        tasks.swap(renderTasks);
+        hasRenderTasks.store(false, std::memory_order_release);
     }
 
-    LOG_DEBUG("Поток рендеринга завершен");
+    for (auto& task : tasks) {
+        task();
+    }
 }
 
 // ==================== Обработка ввода ====================
 void Core::processInput() {
-    // Обработка стандартных клавиш
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+    // Обработка стандартных клавиш (по состоянию из событий - работает и при воспроизведении)
+    if (window && keyState.test(GLFW_KEY_ESCAPE)) {
         LOG_INFO("Клавиша ESC нажата - завершение работы");
         glfwSetWindowShouldClose(window, true);
     }
 
-    // Вызов пользовательского callback'а для клавиш
-    if (keyCallbackFunc) {
-        for (const auto& pair : keyPressed) {
-            if (pair.second) {
-                keyCallbackFunc(pair.first, GLFW_PRESS);
-            }
-        }
-    }
+    // Удерживаемые клавиши опрашиваются через isKeyDown(), callback вызывается только по событиям
     if (camera) {
         camera->updateMovement(deltaTime);
     }
@@ -355,8 +694,23 @@ void Core::shutdown() {
 
     LOG_INFO("Завершение работы движка...");
 
-    // Закрываем окно
+    // Незавершенная трасса дописывается и закрывается
+    Profiler::getInstance().stopCapture();
+
+    // Остановка рабочих потоков (системы выполняются на них)
+    systemScheduler.reset();
+    if (jobSystem) {
+        LOG_INFO("Остановка рабочих потоков...");
+        jobSystem.reset();
+        LOG_INFO("Все потоки остановлены");
+    }
+
+    // Закрываем окно (запросы GPU удаляются, пока контекст еще жив)
     if (window) {
+        gpuProfiler.reset();
+        if (offscreenFramebuffer) {
+            destroyOffscreenTarget();
+        }
         glfwDestroyWindow(window);
         window = nullptr;
         LOG_DEBUG("Окно закрыто");
@@ -366,8 +720,11 @@ void Core::shutdown() {
         camera = nullptr;
     }
     // Завершаем GLFW
-    glfwTerminate();
-    LOG_DEBUG("GLFW завершен");
+    if (glfwInitialized) {
+        glfwTerminate();
+        glfwInitialized = false;
+        LOG_DEBUG("GLFW завершен");
+    }
 
     initialized = false;
     running = false;
@@ -380,41 +737,68 @@ void Core::framebufferSizeCallback(GLFWwindow* window, int width, int height) {
     auto* core = static_cast<Core*>(glfwGetWindowUserPointer(window));
     if (!core) return;
 
+    core->dispatchInput(InputEvent::resize(width, height));
+}
+
+void Core::handleResize(int width, int height) {
     // Обновляем конфигурацию
-    core->config.width = width;
-    core->config.height = height;
+    config.width = width;
+    config.height = height;
 
-    // Обновляем viewport
-    glViewport(0, 0, width, height);
+    // Обновляем viewport (в конвейерном режиме его выставит поток рендеринга по снимку)
+    if (!renderThread.joinable()) {
+        glViewport(0, 0, width, height);
+    }
 
     LOG_INFO("Размер окна изменен: %dx%d", width, height);
 
     // Вызываем пользовательский callback
-    if (core->resizeCallbackFunc) {
-        core->resizeCallbackFunc(width, height);
+    if (resizeCallbackFunc) {
+        resizeCallbackFunc(width, height);
     }
 }
 
 // ==================== Callback для клавиатуры ====================
 void Core::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     auto* core = static_cast<Core*>(glfwGetWindowUserPointer(window));
-    if (!core || !core->camera) return;
+    if (!core) return;
+
+    core->dispatchInput(InputEvent::key(key, scancode, action, mods));
+}
 
-    // Обновляем состояние клавиш
-    core->keyPressed[key] = (action != GLFW_RELEASE);
+void Core::handleKey(int key, int scancode, int action, int mods) {
+    // Обновляем состояние клавиш (GLFW_KEY_UNKNOWN = -1 не храним)
+    if (key >= 0 && key < InputKeyCount) {
+        keyState.set(key, action != GLFW_RELEASE);
+    }
 
     // Устанавливаем флаги движения для камеры (не вызываем processKeyboard!)
-    if (core->camera) {
+    if (camera) {
         bool enable = (action == GLFW_PRESS || action == GLFW_REPEAT);
 
         switch (key) {
-        case GLFW_KEY_W:      core->camera->setMovement(Camera::FORWARD, enable); break;
-        case GLFW_KEY_S:      core->camera->setMovement(Camera::BACKWARD, enable); break;
-        case GLFW_KEY_A:      core->camera->setMovement(Camera::LEFT, enable); break;
-        case GLFW_KEY_D:      core->camera->setMovement(Camera::RIGHT, enable); break;
-        case GLFW_KEY_SPACE:  core->camera->setMovement(Camera::UP, enable); break;
-        case GLFW_KEY_LEFT_SHIFT: core->camera->setMovement(Camera::DOWN, enable); break;
-        case GLFW_KEY_O: core->setVsync(0); break;
+        case GLFW_KEY_W:      camera->setMovement(Camera::FORWARD, enable); break;
+        case GLFW_KEY_S:      camera->setMovement(Camera::BACKWARD, enable); break;
+        case GLFW_KEY_A:      camera->setMovement(Camera::LEFT, enable); break;
+        case GLFW_KEY_D:      camera->setMovement(Camera::RIGHT, enable); break;
+        case GLFW_KEY_SPACE:  camera->setMovement(Camera::UP, enable); break;
+        case GLFW_KEY_LEFT_SHIFT: camera->setMovement(Camera::DOWN, enable); break;
+        }
+    }
+
+    // Горячие клавиши движка (не зависят от камеры)
+    if (action == GLFW_PRESS) {
+        switch (key) {
+        case GLFW_KEY_O: setVsync(0); break;
+        case GLFW_KEY_F3: Profiler::getInstance().logReport(); break;
+        case GLFW_KEY_F4:
+            if (Profiler::isCapturing()) {
+                Profiler::getInstance().stopCapture();
+            }
+            else {
+                Profiler::getInstance().startCapture("trace_" + std::to_string(frameIndex) + ".json");
+            }
+            break;
         }
     }
 
@@ -427,8 +811,8 @@ void Core::keyCallback(GLFWwindow* window, int key, int scancode, int action, in
     }
 
     // Вызываем пользовательский callback
-    if (core->keyCallbackFunc) {
-        core->keyCallbackFunc(key, action);
+    if (keyCallbackFunc) {
+        keyCallbackFunc(key, action);
     }
 }
 
@@ -436,23 +820,29 @@ void Core::keyCallback(GLFWwindow* window, int key, int scancode, int action, in
 // ==================== Callback для движения мыши ====================
 void Core::mouseCallback(GLFWwindow* window, double xpos, double ypos) {
     auto* core = static_cast<Core*>(glfwGetWindowUserPointer(window));
-    if (!core || !core->camera) return;
+    if (!core) return;
+
+    core->dispatchInput(InputEvent::mouseMove(xpos, ypos));
+}
+
+void Core::handleMouseMove(double xpos, double ypos) {
+    if (!camera) return;
 
-    if (core->firstMouse) {
-        core->lastX = xpos;
-        core->lastY = ypos;
-        core->firstMouse = false;
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
     }
 
-    float xoffset = static_cast<float>(xpos - core->lastX);
-    float yoffset = static_cast<float>(core->lastY - ypos); // обратный порядок для Y
+    float xoffset = static_cast<float>(xpos - lastX);
+    float yoffset = static_cast<float>(lastY - ypos); // обратный порядок для Y
 
-    core->lastX = xpos;
-    core->lastY = ypos;
+    lastX = xpos;
+    lastY = ypos;
 
     // Обрабатываем движение мыши только если зажата правая кнопка
-    if (core->mouseButtonPressed) {
-        core->camera->processMouseMovement(xoffset, yoffset);
+    if (mouseButtonPressed) {
+        camera->processMouseMovement(xoffset, yoffset);
     }
 }
 
@@ -461,7 +851,11 @@ void Core::mouseButtonCallback(GLFWwindow* window, int button, int action, int m
     auto* core = static_cast<Core*>(glfwGetWindowUserPointer(window));
     if (!core) return;
 
-    core->mouseButtonPressed = (action == GLFW_PRESS);
+    core->dispatchInput(InputEvent::mouseButton(button, action, mods));
+}
+
+void Core::handleMouseButton(int button, int action, int mods) {
+    mouseButtonPressed = (action == GLFW_PRESS);
 
     // Логируем нажатия
     const char* buttonName = "";
@@ -480,9 +874,85 @@ void Core::mouseButtonCallback(GLFWwindow* window, int button, int action, int m
     }
 
     // Вызываем пользовательский callback
-    if (core->mouseButtonCallbackFunc) {
-        core->mouseButtonCallbackFunc(button, action);
+    if (mouseButtonCallbackFunc) {
+        mouseButtonCallbackFunc(button, action);
+    }
+}
+
+// ==================== Маршрутизация событий ввода ====================
+void Core::dispatchInput(const InputEvent& event) {
+    // Только постановка в очередь - обработка в начале кадра симуляции (pumpInput)
+    if (!inputQueue.tryPush(event)) {
+        ++droppedInputEvents;
+        LOG_WARNING("Очередь ввода переполнена, событие отброшено (всего: %zu)", droppedInputEvents);
+    }
+}
+
+void Core::pumpInput() {
+    size_t count = inputQueue.popBatch(inputBatch.data(), inputBatch.size());
+
+    if (inputRecorder->isPlaying()) {
+        // Во время воспроизведения живой ввод не влияет на симуляцию
+        count = 0;
+        inputRecorder->replayFrame(frameIndex, [this, &count](const InputEvent& event) {
+            if (count < inputBatch.size()) {
+                inputBatch[count++] = event;
+            }
+            });
     }
+    else if (inputRecorder->isRecording()) {
+        for (size_t i = 0; i < count; ++i) {
+            inputRecorder->record(frameIndex, inputBatch[i]);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        handleInputEvent(inputBatch[i]);
+    }
+
+    if (count > 0 && inputBatchCallbackFunc) {
+        inputBatchCallbackFunc(inputBatch.data(), count);
+    }
+}
+
+void Core::handleInputEvent(const InputEvent& event) {
+    switch (event.type) {
+    case InputEvent::Type::Key:
+        handleKey(event.code, event.scancode, event.action, event.mods);
+        break;
+    case InputEvent::Type::MouseMove:
+        handleMouseMove(event.x, event.y);
+        break;
+    case InputEvent::Type::MouseButton:
+        handleMouseButton(event.code, event.action, event.mods);
+        break;
+    case InputEvent::Type::Resize:
+        handleResize(event.code, event.action);
+        break;
+    }
+}
+
+// ==================== Профилирование ====================
+void Core::captureTraceFrames(const std::string& path, uint64_t firstFrame, uint64_t frameCount) {
+    Profiler::getInstance().captureFrames(path, firstFrame, frameCount, frameIndex);
+}
+
+// ==================== Запись и воспроизведение ввода ====================
+void Core::startInputRecording() {
+    inputRecorder->startRecording(frameIndex);
+}
+
+bool Core::stopInputRecording(const std::string& path) {
+    inputRecorder->stopRecording();
+    return inputRecorder->save(path);
+}
+
+bool Core::startInputReplay(const std::string& path) {
+    if (!inputRecorder->load(path)) {
+        return false;
+    }
+    inputRecorder->startPlayback(frameIndex);
+    return true;
 }
 
 // ==================== Инициализация шейдеров по умолчанию ====================
@@ -541,12 +1011,13 @@ out vec3 Normal;
 out vec2 TexCoord;
 
 uniform mat4 model;
+uniform mat3 normalMatrix;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main() {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = normalMatrix * aNormal;
     TexCoord = aTexCoord;
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
@@ -684,7 +1155,9 @@ bool Core::checkGLError(const char* function, const char* file, int line) {
 // ==================== Установка цвета очистки ====================
 void Core::setClearColor(const glm::vec4& color) {
     config.clearColor = color;
-    glClearColor(color.r, color.g, color.b, color.a);
+    if (!renderThread.joinable()) {
+        glClearColor(color.r, color.g, color.b, color.a);
+    }
     LOG_DEBUG("Цвет очистки установлен: (%.2f, %.2f, %.2f, %.2f)",
         color.r, color.g, color.b, color.a);
 }
@@ -719,7 +1192,12 @@ void Core::setLogLevel(LogLevel level) {
 void Core::setVsync(bool vsync)
 {
     config.vsync = vsync;
-    glfwSwapInterval(vsync);
+    if (!window) return;
+
+    // Интервал обмена относится к текущему контексту - выставляем в его потоке
+    enqueueRenderTask([vsync]() {
+        glfwSwapInterval(vsync ? 1 : 0);
+        });
 }
 
 // ==================== Остановка движка ====================
@@ -744,10 +1222,30 @@ void Core::setResizeCallback(ResizeCallback callback) {
     resizeCallbackFunc = std::move(callback);
 }
 
+void Core::setInputBatchCallback(InputBatchCallback callback) {
+    inputBatchCallbackFunc = std::move(callback);
+}
+
 void Core::setUpdateCallback(UpdateCallback callback) {
     updateCallbackFunc = std::move(callback);
 }
 
 void Core::addRenderCallback(std::function<void()> callback) {
     renderCallbacks.push_back(callback);
+}
+
+void Core::addSnapshotCallback(SnapshotCallback callback) {
+    snapshotCallbacks.push_back(std::move(callback));
+}
+
+void Core::enqueueRenderTask(std::function<void()> task) {
+    if (!renderThread.joinable()) {
+        // Контекст принадлежит текущему потоку
+        task();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(renderTaskMutex);
+    renderTasks.push_back(std::move(task));
+    hasRenderTasks.store(true, std::memory_order_release);
 }
\ No newline at end of file
@@ -15,6 +15,8 @@
 
 #include "Logger.h"
 #include "Camera.h"
+#include "FramePipeline.h"
+#include "Input.h"
 
 
 class Camera;
@@ -26,6 +28,10 @@ class Renderer;
 class Camera;
 class ShaderManager;
 class GameObject;
+class JobSystem;
+class SystemScheduler;
+class InputRecorder;
+class GpuProfiler;
 
 // Типы callback'ов
 using KeyCallback = std::function<void(int, int)>;
@@ -33,6 +39,15 @@ using MouseCallback = std::function<void(double, double)>;
 using MouseButtonCallback = std::function<void(int, int)>;
 using ResizeCallback = std::function<void(int, int)>;
 using UpdateCallback = std::function<void(float)>;
+using SnapshotCallback = std::function<void(FrameSnapshot&)>;
+using InputBatchCallback = std::function<void(const InputEvent*, size_t)>;
+
+// Режимы работы без окна
+enum class HeadlessMode {
+    None,           // Обычное окно
+    NoGraphics,     // Без OpenGL: только update-коллбэки и сцена (серверы, пакетные задачи)
+    Offscreen       // Внеэкранный рендеринг через EGL (surfaceless/pbuffer) без дисплея
+};
 
 class Core {
 public:
@@ -47,7 +62,17 @@ public:
         bool vsync = true;
         bool resizable = true;
         bool multithreaded = true;
-        int maxThreads = 4;
+        int maxThreads = 0;         // Рабочих потоков системы заданий (0 - по числу ядер)
+        bool pipelinedRendering = false; // Отдельный поток OpenGL: симуляция кадра N+1 идет во время отрисовки кадра N
+        HeadlessMode headless = HeadlessMode::None;
+        int tickRate = 60;          // Частота симуляции, Гц (0 - переменный шаг, равный времени кадра)
+        int maxCatchUpSteps = 5;    // Максимум шагов симуляции за кадр при отставании
+        bool profiling = true;      // Сбор статистики профилировщика (отчет - клавиша F3)
+        bool gpuProfiling = true;   // Время проходов рендеринга на GPU (дорожка "GPU" профилировщика)
+        // Захват трассы Chrome/Perfetto для диапазона кадров (0 кадров - не захватывать; F4 - вручную)
+        std::string traceCapturePath = "trace.json";
+        uint64_t traceCaptureFirstFrame = 0;
+        uint64_t traceCaptureFrameCount = 0;
         LogLevel logLevel = LogLevel::INFO;
     };
 
@@ -66,20 +91,40 @@ public:
     void run();
     void stop();
 
+    // Детерминированное выполнение: ровно frameCount кадров с фиксированным шагом времени,
+    // без опроса живого ввода и без привязки к системным часам.
+    // Каждый кадр выполняет ровно один шаг симуляции длиной fixedDeltaTime
+    void stepFrames(unsigned int frameCount, float fixedDeltaTime);
+
     // ==================== Установка callback'ов ====================
     void setKeyCallback(KeyCallback callback);
     void setMouseCallback(MouseCallback callback);
     void setMouseButtonCallback(MouseButtonCallback callback);
     void setResizeCallback(ResizeCallback callback);
     void setUpdateCallback(UpdateCallback callback);
+    // Все события ввода кадра одним вызовом (перед обновлением симуляции)
+    void setInputBatchCallback(InputBatchCallback callback);
 
     // ==================== Геттеры ====================
     GLFWwindow* getWindow() const { return window; }
     const Config& getConfig() const { return config; }
     bool isRunning() const { return running; }
+    bool isHeadless() const { return config.headless != HeadlessMode::None; }
     float getDeltaTime() const { return deltaTime; }
+    float getFixedDeltaTime() const { return config.tickRate > 0 ? 1.0f / config.tickRate : deltaTime; }
+    // Доля времени между двумя последними шагами симуляции (для интерполяции при рендеринге)
+    float getInterpolationAlpha() const { return interpolationAlpha; }
     Logger* getLogger() const { return logger; }
     Camera* getCamera() const { return camera; }
+    JobSystem* getJobSystem() const { return jobSystem.get(); }
+    // Параллельное выполнение систем поверх JobSystem
+    SystemScheduler* getSystemScheduler() const { return systemScheduler.get(); }
+    // Для GPU_PROFILE_SCOPE в проходах рендеринга (nullptr - таймеры GPU недоступны)
+    GpuProfiler* getGpuProfiler() const { return gpuProfiler.get(); }
+    uint64_t getFrameIndex() const { return frameIndex; }
+    InputRecorder* getInputRecorder() const { return inputRecorder.get(); }
+    // Состояние клавиши по коду GLFW (по событиям, обработанным в текущем кадре)
+    bool isKeyDown(int key) const { return key >= 0 && key < InputKeyCount && keyState.test(key); }
 
 
     // ==================== Изменение параметров во время выполнения ====================
@@ -91,6 +136,29 @@ public:
 
     void addRenderCallback(std::function<void()> callback);
 
+    // ==================== Профилирование ====================
+    // Захват трассы профилировщика для кадров [firstFrame, firstFrame + frameCount)
+    void captureTraceFrames(const std::string& path, uint64_t firstFrame, uint64_t frameCount);
+
+    // ==================== Запись и воспроизведение ввода ====================
+    void startInputRecording();
+    bool stopInputRecording(const std::string& path);   // Остановить и сохранить журнал
+    bool startInputReplay(const std::string& path);     // Загрузить журнал и воспроизводить с текущего кадра
+
+    // ==================== Конвейерный рендеринг ====================
+    // Callback заполнения снимка кадра (вызывается в потоке симуляции после update).
+    // В конвейерном режиме рендер-коллбэки вызываются в потоке рендеринга после отрисовки снимка
+    // и не должны обращаться к состоянию симуляции
+    void addSnapshotCallback(SnapshotCallback callback);
+
+    // Выполнить задачу в потоке, владеющем контекстом OpenGL (создание/удаление ресурсов).
+    // Без конвейера задача выполняется сразу
+    void enqueueRenderTask(std::function<void()> task);
+
+    // Чтение последнего кадра в RGBA (внеэкранный режим и обычное окно).
+    // Требует контекст в текущем потоке: в конвейерном режиме вызывать из enqueueRenderTask
+    bool readFramebuffer(std::vector<unsigned char>& pixels);
+
 
 private:
     Core();
@@ -102,14 +170,35 @@ private:
     static void mouseCallback(GLFWwindow* window, double xpos, double ypos);
     static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 
+    // ==================== Обработка событий ввода ====================
+    void dispatchInput(const InputEvent& event);     // Живой ввод (с записью в журнал)
+    void handleInputEvent(const InputEvent& event);  // Живой или воспроизведенный ввод
+    void handleKey(int key, int scancode, int action, int mods);
+    void handleMouseMove(double xpos, double ypos);
+    void handleMouseButton(int button, int action, int mods);
+    void handleResize(int width, int height);
+    void pumpInput();                                // Пакетная обработка очереди ввода за кадр
+
     std::vector<std::function<void()>> renderCallbacks;
-    
+    std::vector<SnapshotCallback> snapshotCallbacks;
+
 
     // ==================== Внутренние методы ====================
     void processInput();
     void shutdown();
-    void updateThreadFunction();
+    void beginFrameLoop();
+    void endFrameLoop();
+    void tickFrame(float deltaTime, bool singleStep);
+    void simulateFrame(float deltaTime, bool singleStep);
+    void simulate(float deltaTime);
+    bool initializeGraphics();
+    bool createOffscreenTarget();
+    void destroyOffscreenTarget();
+    void renderFrame();
+    void submitFrame();
+    void drawSnapshot(const FrameSnapshot& frame);
     void renderThreadFunction();
+    void executeRenderTasks();
     void initializeDefaultShaders();
 
     // ==================== Вспомогательные функции ====================
@@ -120,6 +209,7 @@ private:
     GLFWwindow* window = nullptr;
     Config config;
     bool initialized = false;
+    bool glfwInitialized = false;
     bool running = false;
     Logger* logger = nullptr;
 
@@ -129,15 +219,25 @@ private:
     MouseButtonCallback mouseButtonCallbackFunc;
     ResizeCallback resizeCallbackFunc;
     UpdateCallback updateCallbackFunc;
+    InputBatchCallback inputBatchCallbackFunc;
 
     // Состояние ввода
-    std::unordered_map<int, bool> keyPressed;
+    InputEventQueue inputQueue;                 // События от GLFW до обработки в кадре
+    std::vector<InputEvent> inputBatch;         // Пакет событий текущего кадра (память выделена заранее)
+    KeyStateTable keyState;
+    size_t droppedInputEvents = 0;
     glm::dvec2 mousePosition = { 0.0, 0.0 };
     glm::dvec2 lastMousePosition = { 0.0, 0.0 };
     bool mouseButtonPressed = false;
 
+    // Запись/воспроизведение ввода
+    std::unique_ptr<InputRecorder> inputRecorder;
+
     // Тайминг
+    uint64_t frameIndex = 0;
     float deltaTime = 0.0f;
+    double simulationAccumulator = 0.0;   // Накопленное, но еще не просимулированное время
+    float interpolationAlpha = 1.0f;
     float lastFrame = 0.0f;
     float fps = 0.0f;
     int frameCount = 0;
@@ -151,12 +251,26 @@ private:
 
     // Многопоточность
     bool multithreadingEnabled = false;
-    std::vector<std::thread> workerThreads;
-    std::atomic<bool> stopThreads{ false };
-    std::mutex renderMutex;
-    std::condition_variable renderCV;
-    std::atomic<bool> renderReady{ false };
-    std::atomic<bool> updateReady{ false };
+    std::unique_ptr<JobSystem> jobSystem;
+    std::unique_ptr<SystemScheduler> systemScheduler;
+
+    // Таймеры GPU (используются только в потоке, владеющем контекстом OpenGL)
+    std::unique_ptr<GpuProfiler> gpuProfiler;
+
+    // Конвейер симуляция -> рендеринг
+    bool pipelineEnabled = false;
+    std::thread renderThread;
+    FramePipeline framePipeline;
+    int appliedViewportWidth = 0;
+    int appliedViewportHeight = 0;
+    std::mutex renderTaskMutex;
+    std::vector<std::function<void()>> renderTasks;
+    std::atomic<bool> hasRenderTasks{ false };
+
+    // Внеэкранный рендеринг
+    unsigned int offscreenFramebuffer = 0;
+    unsigned int offscreenColorBuffer = 0;
+    unsigned int offscreenDepthBuffer = 0;
 
     // Ресурсы
     std::unique_ptr<ShaderManager> shaderManager;
@@ -0,0 +1,43 @@
+#include "EntityHandle.h"
+#include <cassert>
+
+// ==================== Объекты ====================
+EntityHandle EntityRegistry::create(GameObject* object) {
+    assert(!isInParallelRead() && "EntityRegistry::create в параллельном участке - используйте CommandBuffer");
+    uint32_t index;
+    if (freeHead != EntityHandle::InvalidIndex) {
+        index = freeHead;
+        freeHead = slots[index].nextFree;
+    }
+    else {
+        index = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    Slot& slot = slots[index];
+    slot.object = object;
+    slot.nextFree = EntityHandle::InvalidIndex;
+    ++aliveCount;
+    return { index, slot.generation };
+}
+
+void EntityRegistry::destroy(EntityHandle handle) {
+    assert(!isInParallelRead() && "EntityRegistry::destroy в параллельном участке - используйте CommandBuffer");
+    if (!isAlive(handle)) return;
+
+    Slot& slot = slots[handle.index];
+    slot.object = nullptr;
+
+    // Новое поколение делает недействительными все выданные дескрипторы ячейки
+    if (++slot.generation == 0) slot.generation = 1;
+
+    slot.nextFree = freeHead;
+    freeHead = handle.index;
+    --aliveCount;
+}
+
+void EntityRegistry::relocate(EntityHandle handle, GameObject* object) {
+    assert(!isInParallelRead() && "EntityRegistry::relocate в параллельном участке - используйте CommandBuffer");
+    if (!isAlive(handle)) return;
+    slots[handle.index].object = object;
+}
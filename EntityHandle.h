@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class GameObject;
+
+// ==================== Дескриптор объекта ====================
+// Ссылка на GameObject, не зависящая от его адреса: индекс ячейки в EntityRegistry и поколение.
+// После уничтожения объекта поколение ячейки увеличивается, и старые дескрипторы перестают
+// разрешаться (вместо висячего указателя - nullptr)
+struct EntityHandle {
+    static constexpr uint32_t InvalidIndex = ~0u;
+
+    uint32_t index = InvalidIndex;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == InvalidIndex; }
+    explicit operator bool() const { return !isNull(); }
+
+    // Упаковка в 64 бита (для сериализации и ключей)
+    uint64_t toBits() const { return (static_cast<uint64_t>(generation) << 32) | index; }
+    static EntityHandle fromBits(uint64_t bits) {
+        return { static_cast<uint32_t>(bits), static_cast<uint32_t>(bits >> 32) };
+    }
+
+    bool operator==(const EntityHandle& other) const = default;
+};
+
+template<>
+struct std::hash<EntityHandle> {
+    size_t operator()(const EntityHandle& handle) const noexcept {
+        return std::hash<uint64_t>()(handle.toBits());
+    }
+};
+
+// ==================== Таблица дескрипторов ====================
+// Соответствие дескриптор -> текущий адрес GameObject. Разрешение - O(1): индекс и сравнение поколения.
+// Потоки: resolve можно вызывать одновременно из многих потоков, пока никто не создает, не уничтожает
+// и не перемещает объекты. create / destroy / relocate - только из основного потока и вне параллельных
+// участков. Параллельный участок (системы SystemScheduler) объявляется через ParallelReadScope,
+// и изменения таблицы внутри него ловит assert - структурные изменения оттуда идут через CommandBuffer
+class EntityRegistry {
+public:
+    static EntityRegistry& getInstance() {
+        static EntityRegistry instance;
+        return instance;
+    }
+
+    EntityRegistry(const EntityRegistry&) = delete;
+    EntityRegistry& operator=(const EntityRegistry&) = delete;
+
+    // ==================== Объекты ====================
+    EntityHandle create(GameObject* object);
+    void destroy(EntityHandle handle);
+
+    // Объект переехал по новому адресу (дескриптор остается прежним)
+    void relocate(EntityHandle handle, GameObject* object);
+
+    // ==================== Разрешение ====================
+    GameObject* resolve(EntityHandle handle) const {
+        if (handle.index >= slots.size()) return nullptr;
+        const Slot& slot = slots[handle.index];
+        return slot.generation == handle.generation ? slot.object : nullptr;
+    }
+
+    bool isAlive(EntityHandle handle) const { return resolve(handle) != nullptr; }
+
+    // ==================== Параллельное чтение ====================
+    // Пока объект жив, таблица только читается. Участки могут быть вложенными
+    class ParallelReadScope {
+    public:
+        ParallelReadScope() { EntityRegistry::getInstance().parallelReaders.fetch_add(1, std::memory_order_relaxed); }
+        ~ParallelReadScope() { EntityRegistry::getInstance().parallelReaders.fetch_sub(1, std::memory_order_relaxed); }
+
+        ParallelReadScope(const ParallelReadScope&) = delete;
+        ParallelReadScope& operator=(const ParallelReadScope&) = delete;
+    };
+
+    bool isInParallelRead() const { return parallelReaders.load(std::memory_order_relaxed) != 0; }
+
+    // ==================== Геттеры ====================
+    size_t getAliveCount() const { return aliveCount; }
+    size_t getCapacity() const { return slots.size(); }
+
+private:
+    EntityRegistry() = default;
+
+    struct Slot {
+        GameObject* object = nullptr;
+        uint32_t generation = 1;                            // 0 - только у пустых дескрипторов
+        uint32_t nextFree = EntityHandle::InvalidIndex;
+    };
+
+    std::vector<Slot> slots;
+    uint32_t freeHead = EntityHandle::InvalidIndex;         // Список свободных ячеек
+    size_t aliveCount = 0;
+    std::atomic<int> parallelReaders{ 0 };                  // Открытые ParallelReadScope
+};
@@ -0,0 +1,86 @@
+#include "FrameArena.h"
+#include <atomic>
+
+namespace {
+    // Номер текущего кадра для автоматического сброса арен потоков
+    std::atomic<uint64_t> currentFrame{ 1 };
+}
+
+// ==================== Конструктор ====================
+FrameArena::FrameArena(size_t initialCapacity) {
+    addBlock(initialCapacity);
+}
+
+// ==================== Выделение ====================
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    if (size == 0) size = 1;
+
+    while (true) {
+        Block& block = blocks[currentBlock];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+        uintptr_t aligned = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        size_t end = static_cast<size_t>(aligned - base) + size;
+
+        if (end <= block.size) {
+            offset = end;
+            if (getUsed() > peak) peak = getUsed();
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        // Текущий блок заполнен - переходим к следующему (или создаем его)
+        usedBefore += offset;
+        offset = 0;
+        if (currentBlock + 1 >= blocks.size()) {
+            addBlock(size + alignment);
+        }
+        ++currentBlock;
+    }
+}
+
+void FrameArena::addBlock(size_t minimumSize) {
+    size_t size = blocks.empty() ? minimumSize : blocks.back().size * 2;
+    if (size < minimumSize) size = minimumSize;
+
+    Block block;
+    block.memory = std::make_unique<std::byte[]>(size);
+    block.size = size;
+    blocks.push_back(std::move(block));
+}
+
+// ==================== Сброс ====================
+void FrameArena::reset() {
+    // Кадр не уместился в один блок - заменяем все блоки одним суммарного размера
+    if (blocks.size() > 1) {
+        size_t total = getCapacity();
+        blocks.clear();
+        addBlock(total);
+    }
+
+    currentBlock = 0;
+    offset = 0;
+    usedBefore = 0;
+}
+
+size_t FrameArena::getCapacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+// ==================== Память потока ====================
+FrameArena& FrameArena::getThreadArena() {
+    thread_local FrameArena arena;
+
+    uint64_t frame = currentFrame.load(std::memory_order_acquire);
+    if (arena.frame != frame) {
+        arena.reset();
+        arena.frame = frame;
+    }
+    return arena;
+}
+
+void FrameArena::beginFrame() {
+    currentFrame.fetch_add(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ==================== Линейный аллокатор кадра ====================
+// Временная память, живущая до конца кадра: выделение - сдвиг указателя,
+// освобождение - сброс всего аллокатора раз в кадр. Деструкторы объектов не вызываются,
+// поэтому в арене размещаются только тривиально разрушаемые типы (или контейнеры с ArenaAllocator).
+// Если памяти кадра не хватило, добавляется новый блок; при сбросе блоки сливаются в один,
+// чтобы следующий кадр уложился в один непрерывный блок
+class FrameArena {
+public:
+    static constexpr size_t DefaultCapacity = 1024 * 1024;
+
+    explicit FrameArena(size_t initialCapacity = DefaultCapacity);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // ==================== Выделение ====================
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Деструкторы объектов арены не вызываются");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "Деструкторы объектов арены не вызываются");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Освобождение всей памяти арены (указатели на нее становятся недействительными)
+    void reset();
+
+    // ==================== Память потока ====================
+    // Арена текущего потока. Сбрасывается автоматически при первом обращении в новом кадре,
+    // поэтому память из нее можно использовать только в пределах кадра симуляции
+    static FrameArena& getThreadArena();
+
+    // Начало нового кадра (вызывается из Core)
+    static void beginFrame();
+
+    // ==================== Геттеры ====================
+    size_t getUsed() const { return usedBefore + offset; }
+    size_t getCapacity() const;
+    size_t getPeak() const { return peak; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size = 0;
+    };
+
+    void addBlock(size_t minimumSize);
+
+    std::vector<Block> blocks;
+    size_t currentBlock = 0;
+    size_t offset = 0;          // Занято в текущем блоке
+    size_t usedBefore = 0;      // Занято в предыдущих блоках
+    size_t peak = 0;
+    uint64_t frame = 0;         // Кадр последнего сброса (для арен потоков)
+};
+
+// ==================== STL-аллокатор поверх арены ====================
+// Для контейнеров, живущих до конца кадра. Освобождение памяти - пустая операция
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) noexcept : arena(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(arena->allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+
+private:
+    template<typename U> friend class ArenaAllocator;
+
+    FrameArena* arena;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
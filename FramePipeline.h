@@ -0,0 +1,121 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Предварительные объявления
+class Mesh;
+class ShaderProgram;
+
+// ==================== Элемент рендеринга ====================
+// Все, что поток рендеринга должен знать об одном объекте кадра.
+// Меш и шейдер передаются по сырым указателям: ресурс должен жить,
+// пока кадр с ним находится в конвейере (освобождать через Core::enqueueRenderTask)
+struct RenderItem {
+    glm::mat4 model = glm::mat4(1.0f);     // Матрица модели
+    glm::mat3 normal = glm::mat3(1.0f);    // Матрица нормалей
+    const Mesh* mesh = nullptr;            // Меш для отрисовки
+    ShaderProgram* shader = nullptr;       // Шейдерная программа
+};
+
+// ==================== Снимок кадра ====================
+// Состояние рендеринга, подготовленное симуляцией для одного кадра
+struct FrameSnapshot {
+    uint64_t frameIndex = 0;               // Номер кадра симуляции
+    glm::mat4 view = glm::mat4(1.0f);      // Матрица вида камеры
+    glm::mat4 projection = glm::mat4(1.0f);// Матрица проекции камеры
+    glm::vec3 viewPosition = glm::vec3(0.0f);
+    glm::vec4 clearColor = { 0.1f, 0.1f, 0.2f, 1.0f };
+    int viewportWidth = 0;
+    int viewportHeight = 0;
+    std::vector<RenderItem> items;         // Объекты кадра (память переиспользуется между кадрами)
+
+    // Очистка перед заполнением нового кадра (емкость вектора сохраняется)
+    void reset() {
+        items.clear();
+    }
+};
+
+// ==================== Конвейер кадров ====================
+// Двойная буферизация снимков между потоком симуляции (писатель) и потоком рендеринга (читатель).
+// Пока рендеринг отрисовывает кадр N, симуляция заполняет кадр N+1.
+// Передача построена только на атомарных счетчиках (std::atomic::wait/notify) - без мьютексов
+class FramePipeline {
+public:
+    // ==================== Сторона симуляции ====================
+
+    // Получить буфер для следующего кадра. Ждет, пока рендеринг освободит этот буфер
+    // (симуляция может опережать рендеринг не более чем на один кадр)
+    FrameSnapshot* beginWrite() {
+        uint64_t frame = writeCount + 1;
+        uint64_t done = consumed.load(std::memory_order_acquire);
+        while ((done & StopBit) == 0 && done + 2 < frame) {
+            consumed.wait(done, std::memory_order_acquire);
+            done = consumed.load(std::memory_order_acquire);
+        }
+        if (done & StopBit) return nullptr;
+
+        FrameSnapshot* snapshot = &frames[frame % 2];
+        snapshot->reset();
+        snapshot->frameIndex = frame;
+        return snapshot;
+    }
+
+    // Опубликовать заполненный кадр для потока рендеринга
+    void publish() {
+        ++writeCount;
+        published.fetch_add(1, std::memory_order_release);
+        published.notify_one();
+    }
+
+    // ==================== Сторона рендеринга ====================
+
+    // Дождаться следующего опубликованного кадра (nullptr - конвейер остановлен)
+    const FrameSnapshot* acquire() {
+        uint64_t frame = readCount + 1;
+        uint64_t ready = published.load(std::memory_order_acquire);
+        while ((ready & StopBit) == 0 && ready < frame) {
+            published.wait(ready, std::memory_order_acquire);
+            ready = published.load(std::memory_order_acquire);
+        }
+        if (ready & StopBit) return nullptr;
+
+        return &frames[frame % 2];
+    }
+
+    // Сообщить, что кадр отрисован и его буфер можно переиспользовать
+    void release() {
+        ++readCount;
+        consumed.fetch_add(1, std::memory_order_release);
+        consumed.notify_one();
+    }
+
+    // ==================== Управление ====================
+
+    // Остановить конвейер и разбудить обе стороны
+    void stop() {
+        published.fetch_or(StopBit, std::memory_order_acq_rel);
+        consumed.fetch_or(StopBit, std::memory_order_acq_rel);
+        published.notify_all();
+        consumed.notify_all();
+    }
+
+    // Сброс перед повторным запуском
+    void reset() {
+        published.store(0);
+        consumed.store(0);
+        writeCount = 0;
+        readCount = 0;
+    }
+
+private:
+    static constexpr uint64_t StopBit = 1ull << 63;
+
+    FrameSnapshot frames[2];
+
+    std::atomic<uint64_t> published{ 0 };  // Количество опубликованных кадров
+    std::atomic<uint64_t> consumed{ 0 };   // Количество отрисованных кадров
+    uint64_t writeCount = 0;               // Используется только потоком симуляции
+    uint64_t readCount = 0;                // Используется только потоком рендеринга
+};
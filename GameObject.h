@@ -1,6 +1,10 @@
 #pragma once
 #include "Component.h"
 #include "Transform.h"
+#include "Profiler.h"
+#include "FrameArena.h"
+#include "ArchetypeStorage.h"
+#include "EntityHandle.h"
 #include <memory>
 #include <vector>
 #include <string>
@@ -8,28 +12,104 @@
 #include <algorithm>
 #include <unordered_map>
 #include <typeindex>
+#include <bit>
+#include <atomic>
+#include <cmath>
 
 // Предварительное объявление
 class GameObject;
+
+// Маска слоев: бит N - слой N (объект находится ровно в одном слое из 32)
+using LayerMask = uint32_t;
+constexpr LayerMask AllLayers = ~LayerMask(0);
+
+// ==================== Частота обновления ====================
+// Как часто объект получает Component::update. Пропущенное время накапливается и передается
+// в следующий update, так что объект с интервалом N получает deltaTime N шагов.
+// Объекты с одинаковым интервалом разнесены по шагам (сдвиг по номеру дескриптора),
+// поэтому нагрузка на каждый шаг примерно одинакова
+enum class TickMode {
+    EveryStep,      // Каждый шаг (по умолчанию)
+    Interval,       // Каждые interval шагов
+    Distance        // По расстоянию до точки интереса сцены (обычно камеры)
+};
+
+struct TickPolicy {
+    TickMode mode = TickMode::EveryStep;
+    uint32_t interval = 1;          // Interval: период в шагах
+    float nearDistance = 20.0f;     // Distance: ближе - каждый шаг
+    float farDistance = 100.0f;     // Distance: от near до far период растет до maxInterval, дальше - спящий режим
+    uint32_t maxInterval = 8;
+};
+
+// Наблюдатель за объектом (сцена объекта - для своих кэшей и списков обхода)
+class GameObjectListener {
+public:
+    virtual ~GameObjectListener() = default;
+    // Добавлен или удален компонент, изменился слой
+    virtual void onStructureChanged(GameObject& object) = 0;
+    // Изменился собственный флаг активности
+    virtual void onActivityChanged(GameObject& object) = 0;
+};
 // ==================== Класс GameObject (Игровой Объект) ====================
 // Основной класс для представления любой сущности в игровом мире
 // Реализует компонентный архитектурный паттерн (Entity-Component-System)
 class GameObject {
 private:
     std::string name;                    // Имя объекта для идентификации
-    bool active = true;                  // Флаг активности объекта (включен/выключен)
-    GameObject* parent = nullptr;        // Указатель на родительский объект в иерархии
+    bool activeSelf = true;              // Собственный флаг активности (включен/выключен)
+    // Кэш activeInHierarchy: (эпоха << 1) | флаг. Атомарный - isActive вызывают и параллельные системы,
+    // которые одновременно обновляют кэш общих предков (одинаковым значением для одной эпохи)
+    mutable std::atomic<uint64_t> activeInHierarchyCache{ 0 };
+    EntityHandle handle = EntityRegistry::getInstance().create(this);  // Дескриптор этого объекта
+    EntityHandle parent;                 // Родительский объект в иерархии
+    uint32_t layer = 0;                  // Слой объекта (0..31) для фильтрации запросов
+    GameObjectListener* listener = nullptr;  // Наблюдатель за составом компонентов (сцена объекта)
+    TickPolicy tickPolicy;               // Частота обновления
+    float pendingDelta = 0.0f;           // Время, накопленное с последнего update
+    float tickDelta = 0.0f;              // Время для update на текущем шаге (если ticking)
+    bool ticking = false;                // Объект обновляется на текущем шаге (advanceTick)
+    bool dormant = false;                // Вне радиуса интереса - не обновляется
     Transform* transform = nullptr;      // Указатель на компонент Transform (обязательный)
 
     // Коллекция дочерних объектов (владеем ими через unique_ptr)
     std::vector<std::unique_ptr<GameObject>> children;
 
-    // Все компоненты объекта (владеем ими)
+    // Все компоненты объекта (владеем ими; только в режиме ComponentStorage::Heap)
     std::vector<std::unique_ptr<Component>> allComponents;
 
+    // Компоненты в порядке добавления (в обоих режимах хранения - по ним идут все обходы)
+    std::vector<Component*> components;
+
     // Быстрый доступ к компонентам по их типу (type_index -> список компонентов)
     std::unordered_map<std::type_index, std::vector<Component*>> componentsByType;
 
+    // Доступ за O(1) к зарегистрированным типам: бит N маски - есть компонент с номером N,
+    // слоты упорядочены по номеру типа (первый компонент каждого типа)
+    ComponentMask componentMask = 0;
+    std::vector<Component*> componentSlots;
+
+    // Списки вызова хуков: только компоненты, тип которых переопределяет хук (getComponentHooks)
+    struct TickEntry {
+        Component* component;
+        ComponentTypeId id;
+    };
+    std::vector<TickEntry> updateList;
+    std::vector<Component*> renderList;
+    std::vector<Component*> submitList;
+
+    // Хранение в архетипах: положение в хранилище и типы компонентов в порядке добавления
+    ComponentStorage storage = ComponentStorage::Heap;
+    EntityLocation storageLocation;
+    std::vector<std::type_index> componentTypes;
+
+    // Режим хранения для новых объектов
+    inline static ComponentStorage defaultStorage = ComponentStorage::Heap;
+
+    // Эпоха активности: растет при каждом изменении activeSelf или иерархии,
+    // кэши activeInHierarchy с другой эпохой пересчитываются при обращении
+    inline static std::atomic<uint64_t> activeEpoch{ 1 };
+
     // Инициализация Transform компонента (гарантирует наличие Transform у каждого объекта)
     void initializeTransform() {
         if (!transform) {
@@ -37,11 +117,121 @@ private:
         }
     }
 
+    // ==================== Хранение в архетипах ====================
+
+    // Добавление компонента: объект переходит в архетип с колонкой T.
+    // В архетипе не больше одного компонента каждого типа - повторное добавление возвращает существующий.
+    // start не вызывается (его вызывает addComponent).
+    // Переход переносит ВСЕ компоненты объекта в строку другого блока, а на его старое место -
+    // последний объект архетипа: компонент любого из них, работающий в этот момент, продолжил бы
+    // на перенесенном this. Поэтому во время обхода (ArchetypeStorage::StructuralLock) переход
+    // отклоняется с ошибкой в лог и возвращается nullptr - такие изменения записываются в CommandBuffer
+    template<typename T, typename... Args>
+    T* emplaceArchetypeComponent(Args&&... args) {
+        if (T* existing = getComponent<T>()) {
+            return existing;
+        }
+
+        ArchetypeStorage& archetypes = ArchetypeStorage::getInstance();
+        if (!archetypes.allowMove(storageLocation, name, "добавление компонента")) {
+            return nullptr;
+        }
+        Archetype* target = archetypes.getArchetypeWith(storageLocation.archetype,
+            ComponentTypeInfo::get<T>());
+        storageLocation = archetypes.move(storageLocation, target, handle);
+
+        T* ptr = ::new (archetypes.getComponent(storageLocation, typeid(T))) T(std::forward<Args>(args)...);
+        ptr->setOwner(handle);
+        componentTypes.push_back(typeid(T));
+        refreshComponentPointers();
+        onComponentsChanged();
+        return ptr;
+    }
+
+    // Пересборка указателей после переноса компонентов в хранилище архетипов
+    void refreshComponentPointers() {
+        ArchetypeStorage& archetypes = ArchetypeStorage::getInstance();
+        Archetype* archetype = storageLocation.archetype;
+
+        components.clear();
+        componentsByType.clear();
+        componentSlots.clear();
+        clearTickLists();
+        componentMask = 0;
+        transform = nullptr;
+
+        for (std::type_index type : componentTypes) {
+            int column = archetype->findColumn(type);
+            const ComponentTypeInfo* info = archetype->getTypes()[column];
+            Component* component = info->asComponent(archetypes.getComponent(storageLocation, type));
+
+            components.push_back(component);
+            componentsByType[type].push_back(component);
+            setComponentSlot(info->id, component);
+            addToTickLists(component, info->id, info->hooks);
+            if (type == std::type_index(typeid(Transform))) {
+                transform = static_cast<Transform*>(component);
+            }
+        }
+    }
+
+    // ==================== Списки вызова хуков ====================
+
+    void addToTickLists(Component* component, ComponentTypeId id, ComponentHooks hooks) {
+        if (hooks & HookUpdate) updateList.push_back({ component, id });
+        if (hooks & HookRender) renderList.push_back(component);
+        if (hooks & HookSubmit) submitList.push_back(component);
+    }
+
+    void clearTickLists() {
+        updateList.clear();
+        renderList.clear();
+        submitList.clear();
+    }
+
+    // Состав компонентов изменился. Наблюдатель узнает о любом изменении: даже при той же маске
+    // (незарегистрированные типы) меняются списки хуков и кэш поиска по имени типа
+    void onComponentsChanged() {
+        if (listener) listener->onStructureChanged(*this);
+    }
+
+    // ==================== Слоты компонентов ====================
+
+    // Индекс слота: число компонентов с меньшими номерами типов
+    size_t getSlotIndex(ComponentTypeId id) const {
+        return static_cast<size_t>(std::popcount(componentMask & ((ComponentMask(1) << id) - 1)));
+    }
+
+    // В слоте хранится первый добавленный компонент типа (как и в getComponent по type_index)
+    void setComponentSlot(ComponentTypeId id, Component* component) {
+        if (id == InvalidComponentTypeId) return;
+
+        ComponentMask bit = ComponentMask(1) << id;
+        if (componentMask & bit) return;
+
+        componentSlots.insert(componentSlots.begin() + getSlotIndex(id), component);
+        componentMask |= bit;
+    }
+
+    void clearComponentSlot(ComponentTypeId id) {
+        if (id == InvalidComponentTypeId) return;
+
+        ComponentMask bit = ComponentMask(1) << id;
+        if (!(componentMask & bit)) return;
+
+        componentSlots.erase(componentSlots.begin() + getSlotIndex(id));
+        componentMask &= ~bit;
+    }
+
 public:
+    // Объекты выделяются из общего пула GameObject (см. reservePool)
+    DECLARE_POOLED_ALLOCATION(GameObject)
+
     // ==================== Конструкторы и деструктор ====================
 
     // Основной конструктор
-    GameObject(const std::string& name = "GameObject") : name(name) {
+    GameObject(const std::string& name = "GameObject", ComponentStorage storage = defaultStorage)
+        : name(name), storage(storage) {
         initializeTransform(); // Гарантируем наличие Transform у каждого GameObject
     }
 
@@ -49,11 +239,22 @@ public:
     virtual ~GameObject() {
         // Разрываем связи с дочерними объектами
         for (auto& child : children) {
-            child->parent = nullptr;
+            child->parent = EntityHandle();
         }
         children.clear();
         componentsByType.clear();
+        componentSlots.clear();
+        clearTickLists();
+        components.clear();
         allComponents.clear();
+
+        // Компоненты в хранилище архетипов разрушает хранилище
+        if (storage == ComponentStorage::Archetype) {
+            ArchetypeStorage::getInstance().release(storageLocation);
+        }
+
+        // Дескрипторы объекта больше не разрешаются
+        EntityRegistry::getInstance().destroy(handle);
     }
 
     // Запрещаем копирование (из-за уникальных указателей)
@@ -63,87 +264,234 @@ public:
     // Разрешаем перемещение для оптимизации
     GameObject(GameObject&& other) noexcept
         : name(std::move(other.name)),
-        active(other.active),
+        activeSelf(other.activeSelf),
+        handle(other.handle),
         parent(other.parent),
+        layer(other.layer),
+        listener(other.listener),
+        tickPolicy(other.tickPolicy),
+        pendingDelta(other.pendingDelta),
+        dormant(other.dormant),
         transform(other.transform),
         children(std::move(other.children)),
         allComponents(std::move(other.allComponents)),
-        componentsByType(std::move(other.componentsByType)) {
+        components(std::move(other.components)),
+        componentsByType(std::move(other.componentsByType)),
+        componentMask(other.componentMask),
+        componentSlots(std::move(other.componentSlots)),
+        updateList(std::move(other.updateList)),
+        renderList(std::move(other.renderList)),
+        submitList(std::move(other.submitList)),
+        storage(other.storage),
+        storageLocation(other.storageLocation),
+        componentTypes(std::move(other.componentTypes)) {
+
+        // Дескриптор переходит к новому объекту: дети и компоненты ссылаются на него
+        // и не требуют обновления
+        EntityRegistry::getInstance().relocate(handle, this);
 
         // Обнуляем указатели у исходного объекта
-        other.parent = nullptr;
+        other.handle = EntityHandle();
+        other.parent = EntityHandle();
+        other.listener = nullptr;
         other.transform = nullptr;
-
-        // Обновляем ссылки на родителя у перемещенных детей
-        for (auto& child : children) {
-            child->parent = this;
-        }
+        other.storageLocation = EntityLocation();
+        other.componentMask = 0;
     }
 
     // Оператор перемещающего присваивания
     GameObject& operator=(GameObject&& other) noexcept {
         if (this != &other) {
+            // Собственные компоненты в хранилище архетипов освобождаем до перемещения
+            if (storage == ComponentStorage::Archetype) {
+                ArchetypeStorage::getInstance().release(storageLocation);
+            }
+
+            // Собственный дескриптор уничтожается, объект получает дескриптор other
+            EntityRegistry& registry = EntityRegistry::getInstance();
+            registry.destroy(handle);
+            handle = other.handle;
+            registry.relocate(handle, this);
+
             // Перемещаем все данные
             name = std::move(other.name);
-            active = other.active;
+            activeSelf = other.activeSelf;
+            activeEpoch.fetch_add(1, std::memory_order_relaxed);
             parent = other.parent;
+            layer = other.layer;
+            listener = other.listener;
+            tickPolicy = other.tickPolicy;
+            pendingDelta = other.pendingDelta;
+            dormant = other.dormant;
             transform = other.transform;
             children = std::move(other.children);
             allComponents = std::move(other.allComponents);
+            components = std::move(other.components);
             componentsByType = std::move(other.componentsByType);
+            componentMask = other.componentMask;
+            componentSlots = std::move(other.componentSlots);
+            updateList = std::move(other.updateList);
+            renderList = std::move(other.renderList);
+            submitList = std::move(other.submitList);
+            storage = other.storage;
+            storageLocation = other.storageLocation;
+            componentTypes = std::move(other.componentTypes);
 
             // Обнуляем указатели у исходного объекта
-            other.parent = nullptr;
+            other.handle = EntityHandle();
+            other.parent = EntityHandle();
+            other.listener = nullptr;
             other.transform = nullptr;
+            other.storageLocation = EntityLocation();
+            other.componentMask = 0;
+        }
+        return *this;
+    }
+
+    // ==================== Частота обновления ====================
+
+    const TickPolicy& getTickPolicy() const { return tickPolicy; }
+    void setTickPolicy(const TickPolicy& policy) {
+        tickPolicy = policy;
+        if (tickPolicy.interval == 0) tickPolicy.interval = 1;
+        if (tickPolicy.maxInterval == 0) tickPolicy.maxInterval = 1;
+        dormant = false;
+    }
 
-            // Обновляем ссылки на родителя у перемещенных детей
-            for (auto& child : children) {
-                child->parent = this;
+    // Объект дальше farDistance (TickMode::Distance): update и системы его пропускают
+    bool isDormant() const { return dormant; }
+
+    // Решение для шага step: true - объект обновляется на этом шаге с накопленным временем
+    // getTickDelta() (его update и системы). origin - точка интереса (позиция камеры) для TickMode::Distance
+    bool advanceTick(uint64_t step, const glm::vec3& origin, float deltaTime) {
+        ticking = false;
+        tickDelta = 0.0f;
+        pendingDelta += deltaTime;
+        uint32_t interval = 1;
+
+        switch (tickPolicy.mode) {
+        case TickMode::Interval:
+            interval = tickPolicy.interval;
+            break;
+        case TickMode::Distance: {
+            glm::vec3 offset = (transform ? transform->getCachedWorldPosition() : glm::vec3(0.0f)) - origin;
+            float distanceSq = glm::dot(offset, offset);
+            float nearDistance = tickPolicy.nearDistance;
+            float farDistance = tickPolicy.farDistance;
+
+            // Спящий объект не накапливает время: после пробуждения нет скачка deltaTime
+            dormant = distanceSq >= farDistance * farDistance;
+            if (dormant) {
+                pendingDelta = 0.0f;
+                return false;
             }
+            if (distanceSq > nearDistance * nearDistance) {
+                float t = (std::sqrt(distanceSq) - nearDistance) / std::max(farDistance - nearDistance, 1e-3f);
+                interval = 1 + static_cast<uint32_t>(t * static_cast<float>(tickPolicy.maxInterval - 1));
+            }
+            break;
         }
-        return *this;
+        default:
+            break;
+        }
+
+        if (interval > 1 && (step + handle.index) % interval != 0) return false;
+
+        ticking = true;
+        tickDelta = pendingDelta;
+        pendingDelta = 0.0f;
+        return true;
     }
 
+    // Результат последнего advanceTick: обновляется ли объект на текущем шаге и с каким временем
+    bool isTicking() const { return ticking; }
+    float getTickDelta() const { return tickDelta; }
+
     // ==================== Управление активностью ====================
 
-    // Установка активности объекта (включает/выключает объект и всех его потомков)
+    // Установка собственной активности объекта. Флаги потомков не меняются: неактивный предок
+    // выключает их через activeInHierarchy, и после включения предка они возвращаются
+    // в свое собственное состояние. Стоимость O(1) независимо от размера поддерева
     void setActive(bool isActive) {
-        active = isActive;
-        // Рекурсивно применяем состояние активности ко всем детям
-        for (auto& child : children) {
-            child->setActive(isActive);
+        if (activeSelf == isActive) return;
+        activeSelf = isActive;
+        activeEpoch.fetch_add(1, std::memory_order_relaxed);
+        if (listener) listener->onActivityChanged(*this);
+    }
+
+    bool isActiveSelf() const { return activeSelf; }
+
+    // Объект и все его предки активны. Вычисляется лениво: после изменения активности
+    // где-либо кэш пересчитывается при первом обращении (предки - тоже из кэша).
+    // Можно вызывать из нескольких потоков, пока активность и иерархия не меняются
+    bool isActiveInHierarchy() const {
+        uint64_t epoch = activeEpoch.load(std::memory_order_relaxed);
+        uint64_t cached = activeInHierarchyCache.load(std::memory_order_relaxed);
+        if ((cached >> 1) == epoch) {
+            return (cached & 1) != 0;
         }
+
+        const GameObject* parentObject = getParent();
+        bool active = activeSelf && (!parentObject || parentObject->isActiveInHierarchy());
+        activeInHierarchyCache.store((epoch << 1) | (active ? 1 : 0), std::memory_order_relaxed);
+        return active;
     }
 
-    // Проверка активности объекта
-    bool isActive() const { return active; }
+    // Проверка активности объекта (с учетом предков)
+    bool isActive() const { return isActiveInHierarchy(); }
+
+    // Номер эпохи активности (меняется при любом изменении активности или иерархии)
+    static uint64_t getActiveEpoch() { return activeEpoch.load(std::memory_order_relaxed); }
 
     // ==================== Управление компонентами ====================
 
     // Шаблонный метод для добавления компонента любого типа
     template<typename T, typename... Args>
     T* addComponent(Args&&... args) {
+        // В архетипе компонент типа может быть только один - существующий уже запущен
+        if (storage == ComponentStorage::Archetype) {
+            if (T* existing = getComponent<T>()) {
+                return existing;
+            }
+        }
+
+        T* ptr = emplaceComponent<T>(std::forward<Args>(args)...);
+
+        // Вызываем метод start, если объект активен (nullptr - архетип отклонил добавление)
+        if (ptr && isActive()) {
+            ptr->start();
+        }
+        return ptr;
+    }
+
+    // Добавление компонента без вызова start. Для массового создания объектов (Prefab):
+    // start всех компонентов вызывается потом одним проходом
+    template<typename T, typename... Args>
+    T* emplaceComponent(Args&&... args) {
         // Проверка, что T наследуется от Component
         static_assert(std::is_base_of<Component, T>::value,
             "T должен наследоваться от Component");
 
+        if (storage == ComponentStorage::Archetype) {
+            return emplaceArchetypeComponent<T>(std::forward<Args>(args)...);
+        }
+
         // Создаем компонент с переданными аргументами
         auto component = std::make_unique<T>(std::forward<Args>(args)...);
-        component->setGameObject(this); // Устанавливаем ссылку на GameObject
+        component->setOwner(handle); // Устанавливаем ссылку на GameObject
         T* ptr = component.get(); // Сохраняем сырой указатель
 
         // Добавляем в типизированный список для быстрого доступа
         std::type_index typeIdx = typeid(T);
         auto& list = componentsByType[typeIdx];
         list.push_back(ptr);
+        setComponentSlot(getComponentTypeId<T>(), ptr);
+        addToTickLists(ptr, getComponentTypeId<T>(), getComponentHooks<T>());
 
         // Добавляем в общий список владения
+        components.push_back(ptr);
         allComponents.push_back(std::move(component));
-
-        // Вызываем метод start, если объект активен
-        if (isActive()) {
-            ptr->start();
-        }
+        onComponentsChanged();
 
         return ptr; // Возвращаем указатель на созданный компонент
     }
@@ -151,6 +499,13 @@ public:
     // Получение первого компонента указанного типа
     template<typename T>
     T* getComponent() {
+        // Зарегистрированный тип: проверка бита и индекс слота
+        ComponentTypeId id = getComponentTypeId<T>();
+        if (id != InvalidComponentTypeId) {
+            if (!(componentMask & (ComponentMask(1) << id))) return nullptr;
+            return static_cast<T*>(componentSlots[getSlotIndex(id)]);
+        }
+
         std::type_index typeIdx = typeid(T);
         auto it = componentsByType.find(typeIdx);
         if (it != componentsByType.end() && !it->second.empty()) {
@@ -163,40 +518,121 @@ public:
     template<typename T>
     std::vector<T*> getComponents() {
         std::vector<T*> result;
+        getComponents(result);
+        return result;
+    }
+
+    // Варианты без выделения памяти в куче (для кода, выполняемого каждый кадр)
+
+    // Компоненты дописываются в out (емкость вектора переиспользуется между вызовами)
+    template<typename T, typename Allocator>
+    void getComponents(std::vector<T*, Allocator>& out) {
         std::type_index typeIdx = typeid(T);
         auto it = componentsByType.find(typeIdx);
         if (it != componentsByType.end()) {
             for (auto* comp : it->second) {
-                result.push_back(static_cast<T*>(comp)); // Добавляем все компоненты
+                out.push_back(static_cast<T*>(comp)); // Добавляем все компоненты
             }
         }
+    }
+
+    // Результат во временной памяти кадра (действителен до конца кадра)
+    template<typename T>
+    FrameVector<T*> getComponents(FrameArena& arena) {
+        FrameVector<T*> result{ ArenaAllocator<T*>(arena) };
+        getComponents(result);
         return result;
     }
 
     // Проверка наличия компонента указанного типа
     template<typename T>
     bool hasComponent() {
+        ComponentTypeId id = getComponentTypeId<T>();
+        if (id != InvalidComponentTypeId) {
+            return (componentMask & (ComponentMask(1) << id)) != 0;
+        }
         return getComponent<T>() != nullptr;
     }
 
+    // Маска зарегистрированных типов компонентов объекта
+    ComponentMask getComponentMask() const { return componentMask; }
+
+    // Есть компоненты, переопределяющие render/submit (объект попадает в списки отрисовки сцены)
+    bool hasRenderHooks() const { return !renderList.empty(); }
+    bool hasSubmitHooks() const { return !submitList.empty(); }
+
+    // Все компоненты объекта в порядке добавления
+    const std::vector<Component*>& getAllComponents() const { return components; }
+
+    // func(T&) для каждого компонента T объекта (без выделения памяти)
+    template<typename T, typename Func>
+    void forEachComponent(Func&& func) {
+        ComponentTypeId id = getComponentTypeId<T>();
+        if (id != InvalidComponentTypeId && !(componentMask & (ComponentMask(1) << id))) return;
+
+        auto it = componentsByType.find(typeid(T));
+        if (it == componentsByType.end()) return;
+        for (Component* component : it->second) {
+            func(*static_cast<T*>(component));
+        }
+    }
+
     // Удаление всех компонентов указанного типа
     template<typename T>
     void removeComponent() {
-        std::type_index typeIdx = typeid(T);
+        removeComponent(typeid(T), getComponentTypeId<T>());
+    }
+
+    // То же по типу без шаблона (для отложенных команд). Удаляются компоненты ровно этого типа -
+    // они уже собраны в componentsByType, dynamic_cast по всем компонентам не нужен.
+    // id - номер зарегистрированного типа (InvalidComponentTypeId для незарегистрированных)
+    void removeComponent(std::type_index typeIdx, ComponentTypeId id) {
         auto it = componentsByType.find(typeIdx);
-        if (it != componentsByType.end()) {
-            // Удаляем из общего списка владения
-            allComponents.erase(
-                std::remove_if(allComponents.begin(), allComponents.end(),
-                    [](const std::unique_ptr<Component>& comp) {
-                        return dynamic_cast<T*>(comp.get()) != nullptr;
-                    }),
-                allComponents.end()
-            );
-
-            // Удаляем из типизированного списка
-            componentsByType.erase(it);
+        if (it == componentsByType.end()) return;
+
+        if (storage == ComponentStorage::Archetype) {
+            // Переход в архетип без типа (компонент разрушается хранилищем).
+            // Во время обхода отклоняется (см. emplaceArchetypeComponent)
+            ArchetypeStorage& archetypes = ArchetypeStorage::getInstance();
+            if (!archetypes.allowMove(storageLocation, name, "удаление компонента")) {
+                return;
+            }
+            Archetype* target = archetypes.getArchetypeWithout(storageLocation.archetype, typeIdx);
+            storageLocation = archetypes.move(storageLocation, target, handle);
+            componentTypes.erase(std::remove(componentTypes.begin(), componentTypes.end(), typeIdx),
+                componentTypes.end());
+            refreshComponentPointers();
+            onComponentsChanged();
+            return;
         }
+
+        clearComponentSlot(id);
+
+        // Удаляемые компоненты (обычно один) - список типа
+        const std::vector<Component*>& removed = it->second;
+        auto isRemoved = [&removed](const Component* comp) {
+            return std::find(removed.begin(), removed.end(), comp) != removed.end();
+            };
+
+        // Удаляем из общего списка и списков вызова хуков
+        components.erase(std::remove_if(components.begin(), components.end(), isRemoved), components.end());
+        updateList.erase(
+            std::remove_if(updateList.begin(), updateList.end(),
+                [&isRemoved](const TickEntry& entry) { return isRemoved(entry.component); }),
+            updateList.end());
+        renderList.erase(std::remove_if(renderList.begin(), renderList.end(), isRemoved), renderList.end());
+        submitList.erase(std::remove_if(submitList.begin(), submitList.end(), isRemoved), submitList.end());
+
+        // Удаляем из общего списка владения
+        allComponents.erase(
+            std::remove_if(allComponents.begin(), allComponents.end(),
+                [&isRemoved](const std::unique_ptr<Component>& comp) { return isRemoved(comp.get()); }),
+            allComponents.end()
+        );
+
+        // Удаляем из типизированного списка
+        componentsByType.erase(it);
+        onComponentsChanged();
     }
 
     // ==================== Управление иерархией объектов ====================
@@ -205,10 +641,26 @@ public:
     void addChild(std::unique_ptr<GameObject> child) {
         if (!child) return; // Проверка на null
 
-        child->parent = this; // Устанавливаем себя как родителя
+        child->parent = handle; // Устанавливаем себя как родителя
+        if (child->transform) child->transform->invalidateWorld(); // Мировая матрица зависит от родителя
+        activeEpoch.fetch_add(1, std::memory_order_relaxed);    // Активность тоже
         children.push_back(std::move(child)); // Перемещаем во владение
     }
 
+    // Отсоединение дочернего объекта: владение переходит к вызывающему (nullptr - не наш ребенок)
+    std::unique_ptr<GameObject> detachChild(GameObject* child) {
+        auto it = std::find_if(children.begin(), children.end(),
+            [child](const std::unique_ptr<GameObject>& ptr) { return ptr.get() == child; });
+        if (it == children.end()) return nullptr;
+
+        std::unique_ptr<GameObject> detached = std::move(*it);
+        children.erase(it); // Порядок остальных детей сохраняется
+        detached->parent = EntityHandle();
+        if (detached->transform) detached->transform->invalidateWorld();
+        activeEpoch.fetch_add(1, std::memory_order_relaxed);
+        return detached;
+    }
+
     // Создание нового дочернего объекта
     GameObject* createChild(const std::string& name = "") {
         auto child = std::make_unique<GameObject>(name); // Создаем объект
@@ -218,84 +670,128 @@ public:
     }
 
     // Получение родительского объекта
-    GameObject* getParent() const { return parent; }
+    GameObject* getParent() const { return EntityRegistry::getInstance().resolve(parent); }
+    EntityHandle getParentHandle() const { return parent; }
 
     // Получение списка дочерних объектов (только для чтения)
     const std::vector<std::unique_ptr<GameObject>>& getChildren() const {
         return children;
     }
 
+    // ==================== Обход поддерева ====================
+    // Объекты в сцене обходит Scene по плоской иерархии (SceneHierarchy). Методы ниже - для
+    // отдельных деревьев вне сцены: обход в глубину с явным стеком (родитель раньше детей,
+    // порядок детей сохраняется), без рекурсии. visit возвращает false, чтобы пропустить
+    // поддерево объекта, или true, чтобы продолжить обход его детей
+    template<typename Func>
+    void walkSubtree(Func&& visit) {
+        std::vector<GameObject*> stack{ this };
+        while (!stack.empty()) {
+            GameObject* object = stack.back();
+            stack.pop_back();
+            if (!visit(*object)) continue;
+
+            for (auto it = object->children.rbegin(); it != object->children.rend(); ++it) {
+                stack.push_back(it->get());
+            }
+        }
+    }
+
     // ==================== Поиск объектов в иерархии ====================
 
-    // Поиск объекта по имени (рекурсивный)
+    // Поиск объекта по имени (в глубину, первый найденный)
     GameObject* findByName(const std::string& targetName) {
-        if (name == targetName) return this; // Проверяем себя
-
-        // Рекурсивно проверяем всех детей
-        for (auto& child : children) {
-            GameObject* found = child->findByName(targetName);
-            if (found) return found; // Нашли в поддереве
-        }
-        return nullptr; // Не нашли
+        GameObject* found = nullptr;
+        walkSubtree([&](GameObject& object) {
+            if (!found && object.name == targetName) found = &object;
+            return found == nullptr;
+            });
+        return found;
     }
 
-    // Поиск объекта с определенным компонентом (рекурсивный)
+    // Поиск объекта с определенным компонентом (в глубину, первый найденный)
     template<typename T>
     GameObject* findWithComponent() {
-        if (hasComponent<T>()) return this; // Проверяем себя
-
-        // Рекурсивно проверяем всех детей
-        for (auto& child : children) {
-            GameObject* found = child->findWithComponent<T>();
-            if (found) return found; // Нашли в поддереве
-        }
-        return nullptr; // Не нашли
+        GameObject* found = nullptr;
+        walkSubtree([&](GameObject& object) {
+            if (!found && object.hasComponent<T>()) found = &object;
+            return found == nullptr;
+            });
+        return found;
     }
 
     // ==================== Методы жизненного цикла ====================
+    // Неактивный объект пропускается вместе с поддеревом
 
     // Инициализация объекта (вызывается один раз при создании)
     void start() {
-        if (!active) return; // Пропускаем если объект неактивен
+        walkSubtree([](GameObject& object) {
+            if (!object.activeSelf) return false;
+            object.startComponents();
+            return true;
+            });
+    }
 
-        // Вызываем start у всех компонентов
-        for (auto& component : allComponents) {
-            component->start();
-        }
+    // Обновление объекта (вызывается на каждом шаге симуляции)
+    void update(float deltaTime) {
+        PROFILE_SCOPE("GameObject::update");
+        // Объекты архетипов не переезжают посреди обхода (см. emplaceArchetypeComponent)
+        ArchetypeStorage::StructuralLock lock;
+        walkSubtree([deltaTime](GameObject& object) {
+            if (!object.activeSelf) return false;
+            object.updateComponents(deltaTime);
+            return true;
+            });
+    }
 
-        // Рекурсивно вызываем у всех детей
-        for (auto& child : children) {
-            child->start();
-        }
+    // Отрисовка объекта (вызывается каждый кадр)
+    void render() {
+        PROFILE_SCOPE("GameObject::render");
+        walkSubtree([](GameObject& object) {
+            if (!object.activeSelf) return false;
+            object.renderComponents();
+            return true;
+            });
     }
 
-    // Обновление объекта (вызывается каждый кадр)
-    void update(float deltaTime) {
-        if (!active) return; // Пропускаем если объект неактивен
+    // Передача данных рендеринга в снимок кадра (конвейерный рендеринг, поток симуляции)
+    void submit(FrameSnapshot& frame) {
+        walkSubtree([&frame](GameObject& object) {
+            if (!object.activeSelf) return false;
+            object.submitComponents(frame);
+            return true;
+            });
+    }
 
-        // Вызываем update у всех компонентов
-        for (auto& component : allComponents) {
-            component->update(deltaTime);
+    // Те же шаги только для компонентов самого объекта, без обхода детей
+    // (для линейных обходов, например по плотному массиву объектов Scene).
+    // Активность объекта проверяет вызывающий
+    void startComponents() {
+        for (Component* component : components) {
+            component->start();
         }
+    }
 
-        // Рекурсивно вызываем у всех детей
-        for (auto& child : children) {
-            child->update(deltaTime);
+    // Хуки вызываются только у компонентов, тип которых их переопределяет.
+    // skipped - типы, которые на этом шаге обновляют системы (ComponentTickSystem)
+    void updateComponents(float deltaTime, ComponentMask skipped = 0) {
+        // По индексу: update может добавить компонент (в режиме Heap; в Archetype - см. emplaceArchetypeComponent)
+        for (size_t i = 0; i < updateList.size(); ++i) {
+            const TickEntry& entry = updateList[i];
+            if (entry.id != InvalidComponentTypeId && (skipped & (ComponentMask(1) << entry.id))) continue;
+            entry.component->update(deltaTime);
         }
     }
 
-    // Отрисовка объекта (вызывается каждый кадр)
-    void render() {
-        if (!active) return; // Пропускаем если объект неактивен
-
-        // Вызываем render у всех компонентов
-        for (auto& component : allComponents) {
+    void renderComponents() {
+        for (Component* component : renderList) {
             component->render();
         }
+    }
 
-        // Рекурсивно вызываем у всех детей
-        for (auto& child : children) {
-            child->render();
+    void submitComponents(FrameSnapshot& frame) {
+        for (Component* component : submitList) {
+            component->submit(frame);
         }
     }
 
@@ -304,6 +800,47 @@ public:
     const std::string& getName() const { return name; }
     void setName(const std::string& newName) { name = newName; }
 
+    // Слой объекта (0..31): запросы сцены фильтруют объекты по маске слоев
+    uint32_t getLayer() const { return layer; }
+    LayerMask getLayerBit() const { return LayerMask(1) << layer; }
+    void setLayer(uint32_t newLayer) {
+        newLayer &= 31;
+        if (newLayer == layer) return;
+        layer = newLayer;
+        if (listener) listener->onStructureChanged(*this);
+    }
+
+    // Наблюдатель за составом компонентов и слоем (устанавливает сцена, в которую входит объект)
+    GameObjectListener* getListener() const { return listener; }
+    void setListener(GameObjectListener* newListener) { listener = newListener; }
+
+    // Дескриптор объекта (остается действительным при перемещении объекта в памяти)
+    EntityHandle getHandle() const { return handle; }
+    static GameObject* fromHandle(EntityHandle handle) { return EntityRegistry::getInstance().resolve(handle); }
+
+    // ==================== Пулы памяти ====================
+
+    // Заранее выделить память под count объектов (перед массовым созданием)
+    static void reservePool(size_t count) { ObjectPool<GameObject>::reserve(count); }
+
+    // Заранее выделить память под count компонентов T (только для ComponentStorage::Heap)
+    template<typename T>
+    static void reserveComponents(size_t count) {
+        static_assert(isRegisteredComponent<T>, "Пул есть только у типов с REGISTER_COMPONENT");
+        ObjectPool<T>::reserve(count);
+    }
+
+    // Режим хранения компонентов
+    ComponentStorage getStorage() const { return storage; }
+    static void setDefaultStorage(ComponentStorage mode) { defaultStorage = mode; }
+    static ComponentStorage getDefaultStorage() { return defaultStorage; }
+
+    // Хранилище перенесло компоненты объекта на новое место (вызывается из ArchetypeStorage)
+    void onStorageRelocated(const EntityLocation& location) {
+        storageLocation = location;
+        refreshComponentPointers();
+    }
+
     // Получение компонента Transform (гарантирует его наличие)
     Transform* getTransform() {
         if (!transform) {
@@ -331,9 +868,9 @@ public:
             const glm::vec3& scl = glm::vec3(1.0f),
             const glm::quat& rot = glm::quat(1.0f, 0.0f, 0.0f, 0.0f)) {
             auto transform = gameObject->addComponent<Transform>();
-            transform->position = pos;
-            transform->scale = scl;
-            transform->rotation = rot;
+            transform->setPosition(pos);
+            transform->setScale(scl);
+            transform->setRotation(rot);
             return *this; // Возвращаем this для цепочки вызовов
         }
 
@@ -0,0 +1,136 @@
+#include "GpuProfiler.h"
+#include "Logger.h"
+
+namespace {
+    // Период повторной синхронизации часов CPU и GPU (кадров)
+    constexpr uint64_t CalibrationInterval = 256;
+}
+
+GpuProfiler::~GpuProfiler() {
+    release();
+}
+
+// ==================== Инициализация ====================
+bool GpuProfiler::initialize() {
+    if (available) return true;
+
+    // glQueryCounter и GL_TIMESTAMP - ядро OpenGL 3.3 (ARB_timer_query)
+    if (!GLAD_GL_VERSION_3_3) {
+        LOG_WARNING("Таймеры GPU недоступны (нужен OpenGL 3.3)");
+        return false;
+    }
+
+    for (auto& frame : frames) {
+        glGenQueries(MaxPasses * 2, frame.queries);
+        frame.passes.reserve(MaxPasses);
+        frame.pending = false;
+    }
+
+    track = Profiler::getInstance().createTrack("GPU");
+    calibrate();
+    available = true;
+
+    LOG_DEBUG("Профилировщик GPU инициализирован (задержка чтения: %u кадра)", FrameLatency);
+    return true;
+}
+
+void GpuProfiler::release() {
+    if (!available) return;
+
+    for (auto& frame : frames) {
+        glDeleteQueries(MaxPasses * 2, frame.queries);
+        frame.passes.clear();
+        frame.pending = false;
+    }
+    available = false;
+}
+
+void GpuProfiler::calibrate() {
+    // Текущее время GPU без ожидания завершения команд
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    clockOffset = static_cast<int64_t>(Profiler::now()) - static_cast<int64_t>(gpuTime);
+}
+
+// ==================== Кадр ====================
+void GpuProfiler::beginFrame() {
+    if (!available) return;
+
+    // Слот кадра, записанного FrameLatency кадров назад
+    FrameQueries& frame = frames[frameCounter % FrameLatency];
+    if (frame.pending) {
+        readback(frame);
+    }
+
+    if (frameCounter % CalibrationInterval == 0) {
+        calibrate();
+    }
+
+    frame.passes.clear();
+    frame.lastQuery = 0;
+    depth = 0;
+    inFrame = true;
+}
+
+void GpuProfiler::endFrame() {
+    if (!available || !inFrame) return;
+
+    FrameQueries& frame = frames[frameCounter % FrameLatency];
+    frame.pending = !frame.passes.empty();
+    inFrame = false;
+    ++frameCounter;
+}
+
+// ==================== Проходы ====================
+int GpuProfiler::beginPass(const char* name) {
+    if (!inFrame) return -1;
+
+    FrameQueries& frame = frames[frameCounter % FrameLatency];
+    if (frame.passes.size() >= MaxPasses) return -1;
+
+    int index = static_cast<int>(frame.passes.size());
+    frame.passes.push_back({ name, depth++ });
+
+    GLuint query = frame.queries[index * 2];
+    glQueryCounter(query, GL_TIMESTAMP);
+    frame.lastQuery = query;
+    return index;
+}
+
+void GpuProfiler::endPass(int index) {
+    if (!inFrame || index < 0) return;
+
+    FrameQueries& frame = frames[frameCounter % FrameLatency];
+    GLuint query = frame.queries[index * 2 + 1];
+    glQueryCounter(query, GL_TIMESTAMP);
+    frame.lastQuery = query;
+    --depth;
+}
+
+// ==================== Чтение результатов ====================
+void GpuProfiler::readback(FrameQueries& frame) {
+    frame.pending = false;
+
+    // Запросы завершаются по порядку: готов последний - готовы все.
+    // Если GPU отстает больше чем на FrameLatency кадров, кадр пропускаем, а не ждем
+    GLuint ready = 0;
+    glGetQueryObjectuiv(frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &ready);
+    if (!ready) {
+        LOG_DEBUG("Профилировщик GPU: результаты кадра не готовы, кадр пропущен");
+        return;
+    }
+
+    Profiler& profiler = Profiler::getInstance();
+    for (size_t i = 0; i < frame.passes.size(); ++i) {
+        GLuint64 start = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+        if (end < start) continue;
+
+        profiler.recordZone(track, frame.passes[i].name,
+            static_cast<uint64_t>(static_cast<int64_t>(start) + clockOffset),
+            static_cast<uint64_t>(static_cast<int64_t>(end) + clockOffset),
+            frame.passes[i].depth);
+    }
+}
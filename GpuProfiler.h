@@ -0,0 +1,94 @@
+#pragma once
+#include "Profiler.h"
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+
+// ==================== Профилировщик GPU ====================
+// Время проходов рендеринга на GPU по меткам времени (glQueryCounter + GL_TIMESTAMP).
+// Запросы берутся из пула на FrameLatency кадров: результаты кадра читаются через
+// несколько кадров и только если уже готовы, поэтому CPU никогда не ждет GPU.
+// Результаты попадают в дорожку "GPU" профилировщика рядом с зонами CPU.
+// Все методы вызываются в потоке, владеющем контекстом OpenGL
+class GpuProfiler {
+public:
+    static constexpr unsigned int FrameLatency = 4;    // Кадров между записью и чтением
+    static constexpr unsigned int MaxPasses = 64;      // Проходов на кадр
+
+    GpuProfiler() = default;
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // Создание пула запросов (нужен текущий контекст OpenGL 3.3+). false - таймеры недоступны
+    bool initialize();
+    void release();
+
+    // ==================== Кадр ====================
+    void beginFrame();
+    void endFrame();
+
+    // ==================== Проходы ====================
+    // Возвращает индекс прохода (-1 - проход не измеряется). Имя - строковый литерал
+    int beginPass(const char* name);
+    void endPass(int index);
+
+    bool isAvailable() const { return available; }
+
+private:
+    struct Pass {
+        const char* name;
+        uint32_t depth;
+    };
+
+    // Запросы одного кадра: у прохода i метки начала и конца - queries[2i] и queries[2i + 1]
+    struct FrameQueries {
+        GLuint queries[MaxPasses * 2] = {};
+        std::vector<Pass> passes;
+        GLuint lastQuery = 0;          // Последний выданный запрос кадра (готов - готовы все)
+        bool pending = false;
+    };
+
+    void readback(FrameQueries& frame);
+    void calibrate();
+
+    FrameQueries frames[FrameLatency];
+    uint64_t frameCounter = 0;
+    uint32_t depth = 0;
+    bool inFrame = false;
+    bool available = false;
+
+    int64_t clockOffset = 0;           // Часы профилировщика минус часы GPU, нс
+    uint32_t track = 0;
+};
+
+// ==================== Проход GPU (RAII) ====================
+class GpuScope {
+public:
+    GpuScope(GpuProfiler* profiler, const char* name)
+        : profiler(profiler && profiler->isAvailable() && Profiler::isEnabled() ? profiler : nullptr) {
+        if (this->profiler) {
+            index = this->profiler->beginPass(name);
+        }
+    }
+
+    ~GpuScope() {
+        if (profiler) {
+            profiler->endPass(index);
+        }
+    }
+
+    GpuScope(const GpuScope&) = delete;
+    GpuScope& operator=(const GpuScope&) = delete;
+
+private:
+    GpuProfiler* profiler;
+    int index = -1;
+};
+
+#ifndef ENGINE_DISABLE_PROFILING
+#define GPU_PROFILE_SCOPE(profiler, name)   GpuScope PROFILE_CONCAT(gpuScope, __LINE__)(profiler, name)
+#else
+#define GPU_PROFILE_SCOPE(profiler, name)   ((void)0)
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+#include "SpscRingBuffer.h"
+#include <bitset>
+#include <cstdint>
+
+// ==================== Событие ввода ====================
+// Единое представление событий GLFW (клавиатура, мышь, изменение размера окна).
+// Используется для записи и воспроизведения ввода
+struct InputEvent {
+    enum class Type : uint8_t {
+        Key,            // code - клавиша, scancode, action, mods
+        MouseMove,      // x, y - позиция курсора
+        MouseButton,    // code - кнопка, action, mods
+        Resize          // code - ширина, action - высота
+    };
+
+    Type type = Type::Key;
+    int code = 0;
+    int scancode = 0;
+    int action = 0;
+    int mods = 0;
+    double x = 0.0;
+    double y = 0.0;
+
+    // ==================== Фабричные методы ====================
+    static InputEvent key(int key, int scancode, int action, int mods) {
+        InputEvent event;
+        event.type = Type::Key;
+        event.code = key;
+        event.scancode = scancode;
+        event.action = action;
+        event.mods = mods;
+        return event;
+    }
+
+    static InputEvent mouseMove(double x, double y) {
+        InputEvent event;
+        event.type = Type::MouseMove;
+        event.x = x;
+        event.y = y;
+        return event;
+    }
+
+    static InputEvent mouseButton(int button, int action, int mods) {
+        InputEvent event;
+        event.type = Type::MouseButton;
+        event.code = button;
+        event.action = action;
+        event.mods = mods;
+        return event;
+    }
+
+    static InputEvent resize(int width, int height) {
+        InputEvent event;
+        event.type = Type::Resize;
+        event.code = width;
+        event.action = height;
+        return event;
+    }
+};
+
+// ==================== Очередь и состояние ввода ====================
+// Поток окна (обработка событий GLFW) пишет, поток симуляции читает пакетами раз в кадр
+using InputEventQueue = SpscRingBuffer<InputEvent, 1024>;
+
+// Состояние клавиш, индекс - код клавиши GLFW (GLFW_KEY_LAST = 348)
+constexpr int InputKeyCount = 512;
+using KeyStateTable = std::bitset<InputKeyCount>;
@@ -0,0 +1,238 @@
+#include "InputRecorder.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// ==================== Формат журнала ====================
+// Заголовок: "EIR1" + количество записей (uint32).
+// Запись: разница номеров кадров (varint), тип (1 байт), данные по типу:
+//   Key         - код и scancode (zigzag varint), action и mods (по 1 байту)
+//   MouseMove   - x, y (double, без потери точности)
+//   MouseButton - кнопка, action, mods (по 1 байту)
+//   Resize      - ширина, высота (varint)
+namespace {
+    const char JournalMagic[4] = { 'E', 'I', 'R', '1' };
+
+    void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void writeSigned(std::vector<uint8_t>& out, int value) {
+        // zigzag: небольшие отрицательные значения (GLFW_KEY_UNKNOWN = -1) тоже занимают 1 байт
+        uint32_t zigzag = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+        writeVarint(out, zigzag);
+    }
+
+    void writeDouble(std::vector<uint8_t>& out, double value) {
+        uint8_t bytes[sizeof(double)];
+        std::memcpy(bytes, &value, sizeof(double));
+        out.insert(out.end(), bytes, bytes + sizeof(double));
+    }
+
+    // Последовательное чтение из буфера с проверкой границ
+    struct Reader {
+        const std::vector<uint8_t>& data;
+        size_t offset = 0;
+        bool failed = false;
+
+        uint8_t byte() {
+            if (offset >= data.size()) { failed = true; return 0; }
+            return data[offset++];
+        }
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                uint8_t b = byte();
+                value |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80) || failed) return value;
+            }
+            failed = true;
+            return 0;
+        }
+
+        int signedValue() {
+            uint32_t zigzag = static_cast<uint32_t>(varint());
+            return static_cast<int>((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+        }
+
+        double real() {
+            if (offset + sizeof(double) > data.size()) { failed = true; return 0.0; }
+            double value;
+            std::memcpy(&value, &data[offset], sizeof(double));
+            offset += sizeof(double);
+            return value;
+        }
+    };
+}
+
+// ==================== Запись ====================
+void InputRecorder::startRecording(uint64_t currentFrame) {
+    records.clear();
+    cursor = 0;
+    baseFrame = currentFrame;
+    state = State::Recording;
+    LOG_INFO("Запись ввода начата (кадр %llu)", static_cast<unsigned long long>(currentFrame));
+}
+
+void InputRecorder::stopRecording() {
+    if (state != State::Recording) return;
+    state = State::Idle;
+    LOG_INFO("Запись ввода остановлена: %zu событий", records.size());
+}
+
+void InputRecorder::record(uint64_t frame, const InputEvent& event) {
+    if (state != State::Recording || frame < baseFrame) return;
+    records.push_back({ frame - baseFrame, event });
+}
+
+// ==================== Воспроизведение ====================
+void InputRecorder::startPlayback(uint64_t currentFrame) {
+    cursor = 0;
+    baseFrame = currentFrame;
+    state = records.empty() ? State::Idle : State::Playing;
+    LOG_INFO("Воспроизведение ввода: %zu событий", records.size());
+}
+
+void InputRecorder::stopPlayback() {
+    if (state == State::Playing) {
+        state = State::Idle;
+    }
+}
+
+void InputRecorder::clear() {
+    records.clear();
+    cursor = 0;
+    state = State::Idle;
+}
+
+// ==================== Сохранение ====================
+bool InputRecorder::save(const std::string& path) const {
+    std::vector<uint8_t> data;
+    data.reserve(8 + records.size() * 8);
+
+    data.insert(data.end(), JournalMagic, JournalMagic + 4);
+    uint32_t count = static_cast<uint32_t>(records.size());
+    for (int i = 0; i < 4; ++i) {
+        data.push_back(static_cast<uint8_t>(count >> (i * 8)));
+    }
+
+    uint64_t previousFrame = 0;
+    for (const Record& record : records) {
+        writeVarint(data, record.frame - previousFrame);
+        previousFrame = record.frame;
+
+        const InputEvent& event = record.event;
+        data.push_back(static_cast<uint8_t>(event.type));
+
+        switch (event.type) {
+        case InputEvent::Type::Key:
+            writeSigned(data, event.code);
+            writeSigned(data, event.scancode);
+            data.push_back(static_cast<uint8_t>(event.action));
+            data.push_back(static_cast<uint8_t>(event.mods));
+            break;
+        case InputEvent::Type::MouseMove:
+            writeDouble(data, event.x);
+            writeDouble(data, event.y);
+            break;
+        case InputEvent::Type::MouseButton:
+            data.push_back(static_cast<uint8_t>(event.code));
+            data.push_back(static_cast<uint8_t>(event.action));
+            data.push_back(static_cast<uint8_t>(event.mods));
+            break;
+        case InputEvent::Type::Resize:
+            writeVarint(data, static_cast<uint32_t>(event.code));
+            writeVarint(data, static_cast<uint32_t>(event.action));
+            break;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_ERROR("Не удалось открыть файл журнала ввода: %s", path.c_str());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    LOG_INFO("Журнал ввода сохранен: %s (%zu событий, %zu байт)", path.c_str(), records.size(), data.size());
+    return file.good();
+}
+
+// ==================== Загрузка ====================
+bool InputRecorder::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_ERROR("Не удалось открыть файл журнала ввода: %s", path.c_str());
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < 8 || std::memcmp(data.data(), JournalMagic, 4) != 0) {
+        LOG_ERROR("Неверный формат журнала ввода: %s", path.c_str());
+        return false;
+    }
+
+    uint32_t count = 0;
+    for (int i = 0; i < 4; ++i) {
+        count |= static_cast<uint32_t>(data[4 + i]) << (i * 8);
+    }
+
+    Reader reader{ data, 8 };
+    std::vector<Record> loaded;
+    // Счетчик из заголовка еще не проверен: запись занимает минимум 2 байта (кадр и тип),
+    // поэтому поврежденный заголовок не приведет к огромному выделению памяти
+    loaded.reserve(std::min<size_t>(count, (data.size() - 8) / 2));
+
+    uint64_t frame = 0;
+    for (uint32_t i = 0; i < count && !reader.failed; ++i) {
+        frame += reader.varint();
+
+        InputEvent event;
+        event.type = static_cast<InputEvent::Type>(reader.byte());
+
+        switch (event.type) {
+        case InputEvent::Type::Key:
+            event.code = reader.signedValue();
+            event.scancode = reader.signedValue();
+            event.action = reader.byte();
+            event.mods = reader.byte();
+            break;
+        case InputEvent::Type::MouseMove:
+            event.x = reader.real();
+            event.y = reader.real();
+            break;
+        case InputEvent::Type::MouseButton:
+            event.code = reader.byte();
+            event.action = reader.byte();
+            event.mods = reader.byte();
+            break;
+        case InputEvent::Type::Resize:
+            event.code = static_cast<int>(reader.varint());
+            event.action = static_cast<int>(reader.varint());
+            break;
+        default:
+            reader.failed = true;
+            break;
+        }
+
+        loaded.push_back({ frame, event });
+    }
+
+    if (reader.failed) {
+        LOG_ERROR("Журнал ввода поврежден: %s", path.c_str());
+        return false;
+    }
+
+    records = std::move(loaded);
+    cursor = 0;
+    state = State::Idle;
+    LOG_INFO("Журнал ввода загружен: %s (%zu событий)", path.c_str(), records.size());
+    return true;
+}
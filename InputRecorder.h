@@ -0,0 +1,68 @@
+#pragma once
+#include "Input.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ==================== Запись и воспроизведение ввода ====================
+// Сохраняет события ввода с номером кадра в компактный бинарный журнал
+// и воспроизводит их в тех же кадрах. Вместе с Core::stepFrames дает
+// полностью повторяемые сессии для сравнения производительности сборок
+class InputRecorder {
+public:
+    enum class State {
+        Idle,
+        Recording,
+        Playing
+    };
+
+    // ==================== Запись ====================
+    // currentFrame - номер кадра движка, с которого начинается журнал
+    void startRecording(uint64_t currentFrame);
+    void stopRecording();
+    void record(uint64_t frame, const InputEvent& event);
+
+    // ==================== Воспроизведение ====================
+    void startPlayback(uint64_t currentFrame);
+    void stopPlayback();
+
+    // Вызывает handler для каждого события кадра frame (события идут в порядке записи)
+    template<typename Handler>
+    void replayFrame(uint64_t currentFrame, Handler&& handler) {
+        if (state != State::Playing || currentFrame < baseFrame) return;
+
+        uint64_t frame = currentFrame - baseFrame;
+        while (cursor < records.size() && records[cursor].frame <= frame) {
+            if (records[cursor].frame == frame) {
+                handler(records[cursor].event);
+            }
+            ++cursor;
+        }
+
+        if (cursor >= records.size()) {
+            state = State::Idle; // Журнал закончился - возвращаемся к живому вводу
+        }
+    }
+
+    // ==================== Файлы ====================
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // ==================== Геттеры ====================
+    State getState() const { return state; }
+    bool isRecording() const { return state == State::Recording; }
+    bool isPlaying() const { return state == State::Playing; }
+    size_t getEventCount() const { return records.size(); }
+    void clear();
+
+private:
+    struct Record {
+        uint64_t frame;
+        InputEvent event;
+    };
+
+    State state = State::Idle;
+    uint64_t baseFrame = 0;    // Кадры в журнале отсчитываются от начала записи/воспроизведения
+    std::vector<Record> records;
+    size_t cursor = 0;
+};
@@ -0,0 +1,192 @@
+#include "JobSystem.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+namespace {
+    // Индекс очереди текущего потока (0 - главный или внешний поток)
+    thread_local unsigned int currentThreadIndex = 0;
+}
+
+// ==================== Конструктор ====================
+JobSystem::JobSystem(unsigned int workerCount) {
+    // Очередь 0 - для главного потока, далее по одной на каждый рабочий поток
+    for (unsigned int i = 0; i <= workerCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    for (unsigned int i = 1; i <= workerCount; ++i) {
+        threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+
+    LOG_DEBUG("Система заданий запущена (%u рабочих потоков)", workerCount);
+}
+
+// ==================== Деструктор ====================
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCV.notify_all();
+
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads.clear();
+
+    // Задания, оставшиеся в очередях, выполняем на текущем потоке,
+    // чтобы не оставить ожидающие счетчики навсегда ненулевыми
+    while (tryExecuteOne(0)) {}
+
+    LOG_DEBUG("Система заданий остановлена");
+}
+
+unsigned int JobSystem::getDefaultWorkerCount() {
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+}
+
+unsigned int JobSystem::getCurrentThreadIndex() {
+    return currentThreadIndex;
+}
+
+// ==================== Планирование ====================
+void JobSystem::schedule(std::function<void()> function, JobCounter* counter) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    unsigned int index = currentThreadIndex < queues.size() ? currentThreadIndex : 0;
+    push(index, Job{ std::move(function), counter });
+}
+
+void JobSystem::scheduleAfter(JobCounter& dependency, std::function<void()> function,
+    JobCounter* counter) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job job{ std::move(function), counter };
+    {
+        // Проверка и добавление под одной блокировкой: execute забирает
+        // список под той же блокировкой после обнуления счетчика
+        std::lock_guard<std::mutex> lock(dependency.continuationMutex);
+        if (!dependency.isDone()) {
+            dependency.continuations.push_back(std::move(job));
+            return;
+        }
+    }
+
+    unsigned int index = currentThreadIndex < queues.size() ? currentThreadIndex : 0;
+    push(index, std::move(job));
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    unsigned int index = currentThreadIndex < queues.size() ? currentThreadIndex : 0;
+
+    // Помогаем выполнять задания, пока группа не завершится
+    while (!counter.isDone()) {
+        if (!tryExecuteOne(index)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Дожидаемся, пока поток, обнуливший счетчик, отпустит его блокировку
+    std::lock_guard<std::mutex> lock(counter.continuationMutex);
+}
+
+// ==================== Рабочий поток ====================
+void JobSystem::workerLoop(unsigned int index) {
+    currentThreadIndex = index;
+    Profiler::getInstance().setThreadName("Рабочий поток " + std::to_string(index));
+
+    while (!stopping.load(std::memory_order_acquire)) {
+        if (tryExecuteOne(index)) {
+            continue;
+        }
+
+        // Заданий нет - засыпаем до появления новых
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCV.wait(lock, [this]() {
+            return queuedJobs.load(std::memory_order_acquire) > 0 || stopping.load();
+            });
+    }
+}
+
+// ==================== Работа с очередями ====================
+void JobSystem::push(unsigned int queueIndex, Job job) {
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+        queues[queueIndex]->jobs.push_back(std::move(job));
+    }
+
+    queuedJobs.fetch_add(1, std::memory_order_release);
+    {
+        // Пустая блокировка исключает потерю пробуждения между проверкой условия и сном
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCV.notify_one();
+}
+
+bool JobSystem::popLocal(unsigned int queueIndex, Job& job) {
+    WorkerQueue& queue = *queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+
+    // Свои задания берем с конца (LIFO - данные еще в кэше)
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::steal(unsigned int thiefIndex, Job& job) {
+    size_t count = queues.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        WorkerQueue& victim = *queues[(thiefIndex + offset) % count];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.jobs.empty()) continue;
+
+        // Чужие задания крадем с начала (FIFO - самые крупные куски работы)
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::tryExecuteOne(unsigned int queueIndex) {
+    Job job;
+    if (!popLocal(queueIndex, job) && !steal(queueIndex, job)) {
+        return false;
+    }
+
+    queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(Job& job) {
+    if (job.function) {
+        PROFILE_SCOPE("Job");
+        job.function();
+    }
+
+    if (!job.counter) return;
+
+    // Обнуление счетчика и забор зависимых заданий выполняются под блокировкой счетчика:
+    // после ее снятия счетчик больше не используется и может быть уничтожен ожидающим
+    std::vector<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(job.counter->continuationMutex);
+        if (job.counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(job.counter->continuations);
+        }
+    }
+
+    unsigned int index = currentThreadIndex < queues.size() ? currentThreadIndex : 0;
+    for (auto& readyJob : ready) {
+        push(index, std::move(readyJob));
+    }
+}
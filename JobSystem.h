@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobCounter;
+
+// ==================== Задание ====================
+// Единица работы для системы заданий
+struct Job {
+    std::function<void()> function;     // Выполняемая функция
+    JobCounter* counter = nullptr;       // Счетчик, уменьшаемый после выполнения
+};
+
+// ==================== Счетчик заданий ====================
+// Отслеживает количество незавершенных заданий группы.
+// Используется для ожидания и для построения зависимостей между заданиями
+class JobCounter {
+public:
+    JobCounter() = default;
+
+    // Запрещаем копирование (на счетчик ссылаются выполняющиеся задания)
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    // Все задания группы завершены
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+    // Количество незавершенных заданий
+    int getPending() const { return pending.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> pending{ 0 };
+
+    // Задания, ожидающие обнуления счетчика (зависимые задания)
+    std::mutex continuationMutex;
+    std::vector<Job> continuations;
+};
+
+// ==================== Система заданий ====================
+// Пул рабочих потоков с отдельной очередью (deque) на каждый поток и кражей работы:
+// владелец берет задания с конца своей очереди, остальные потоки крадут с начала.
+// Очередь с индексом 0 принадлежит главному (и любому внешнему) потоку
+class JobSystem {
+public:
+    // workerCount - количество рабочих потоков (0 - все задания выполняет ожидающий поток)
+    explicit JobSystem(unsigned int workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Количество рабочих потоков по умолчанию (аппаратные потоки минус главный)
+    static unsigned int getDefaultWorkerCount();
+
+    // ==================== Планирование ====================
+
+    // Поставить задание в очередь текущего потока
+    void schedule(std::function<void()> function, JobCounter* counter = nullptr);
+
+    // Поставить задание, которое начнет выполняться только после завершения dependency
+    void scheduleAfter(JobCounter& dependency, std::function<void()> function,
+        JobCounter* counter = nullptr);
+
+    // Ожидание завершения группы заданий.
+    // Ожидающий поток не простаивает, а выполняет задания из очередей ("помощь при ожидании")
+    void wait(JobCounter& counter);
+
+    // Параллельный цикл: диапазон [0, count) делится на части по grainSize элементов,
+    // func(begin, end) вызывается для каждой части. Возвращает управление после завершения всех частей
+    template<typename Func>
+    void parallelFor(size_t count, size_t grainSize, Func&& func) {
+        if (count == 0) return;
+        if (grainSize == 0) grainSize = 1;
+
+        // Маленький диапазон выполняем сразу, без накладных расходов на задания
+        if (count <= grainSize || threads.empty()) {
+            func(size_t(0), count);
+            return;
+        }
+
+        JobCounter counter;
+        for (size_t begin = 0; begin < count; begin += grainSize) {
+            size_t end = begin + grainSize < count ? begin + grainSize : count;
+            schedule([&func, begin, end]() { func(begin, end); }, &counter);
+        }
+        wait(counter);
+    }
+
+    // ==================== Геттеры ====================
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(threads.size()); }
+
+    // Индекс очереди текущего потока (0 - главный/внешний поток, 1..N - рабочие)
+    static unsigned int getCurrentThreadIndex();
+
+private:
+    // Очередь заданий одного потока
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void workerLoop(unsigned int index);
+    void push(unsigned int queueIndex, Job job);
+    bool popLocal(unsigned int queueIndex, Job& job);
+    bool steal(unsigned int thiefIndex, Job& job);
+    bool tryExecuteOne(unsigned int queueIndex);
+    void execute(Job& job);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+
+    // Сон рабочих потоков при отсутствии заданий
+    std::atomic<bool> stopping{ false };
+    std::atomic<int> queuedJobs{ 0 };
+    std::mutex sleepMutex;
+    std::condition_variable sleepCV;
+};
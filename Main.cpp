@@ -1,10 +1,48 @@
 #include "Core.h"
 #include "GameObject.h"
 #include "MeshRenderer.h"
+#include "Prefab.h"
+#include "SystemScheduler.h"
+#include "Scene.h"
 #include <iostream>
 #include <locale>
 #include <memory>
 
+// ==================== Покачивание объектов ====================
+// Данные для BobbingSystem: сдвиг фазы и скорость вращения (градусов в секунду)
+class Bobbing : public Component {
+public:
+    float phase = 0.0f;
+    float spinSpeed = 30.0f;
+
+    REGISTER_COMPONENT(Bobbing)
+};
+
+// Плавное движение объектов вокруг центра (объекты обрабатываются параллельно)
+class BobbingSystem : public System {
+public:
+    BobbingSystem() : System("BobbingSystem") {
+        reads<Bobbing>();
+        writes<Transform>();
+    }
+
+    void update(const SystemContext& context) override {
+        float deltaTime = context.getDeltaTime();
+        time += deltaTime;
+
+        context.forEach<Bobbing, Transform>([this](GameObject& object, Bobbing& bobbing, Transform& transform) {
+            glm::vec3 position = transform.getPosition();
+            position.y = sinf(time + bobbing.phase) * 0.5f;
+            transform.setPosition(position);
+            // Время с прошлого обновления объекта (TickPolicy)
+            transform.rotate(bobbing.spinSpeed * object.getTickDelta(), glm::vec3(0.0f, 1.0f, 0.0f));
+            });
+    }
+
+private:
+    float time = 0.0f;
+};
+
 class MyApplication {
 public:
     void run() {
@@ -18,6 +56,8 @@ public:
         config.height = 720;
         config.title = "Мой Движок";
         config.multithreaded = false;
+        config.pipelinedRendering = false;
+        config.tickRate = 60;
         config.logLevel = LogLevel::TRACE;
         config.clearColor = glm::vec4(0.1f, 0.1f, 0.2f, 1.0f);
 
@@ -26,6 +66,8 @@ public:
         LOG_INFO("  WASD - движение камеры");
         LOG_INFO("  Space/Shift - вверх/вниз");
         LOG_INFO("  Правая кнопка мыши + движение - поворот камеры");
+        LOG_INFO("  F3 - отчет профилировщика");
+        LOG_INFO("  F4 - начать/остановить запись трассы (chrome://tracing, Perfetto)");
         LOG_INFO("  ESC - выход");
 
         // ==================== Инициализация ядра ====================
@@ -39,42 +81,44 @@ public:
         LOG_INFO("Создание игровых объектов...");
 
         // Создаем пол (большой квадрат)
-        auto floor = std::make_unique<GameObject>("Пол");
-        floor->getTransform()->position = glm::vec3(0.0f, -2.0f, 0.0f);
-        floor->getTransform()->scale = glm::vec3(10.0f, 1.1f, 10.0f);
+        GameObject* floor = scene.resolve(scene.createGameObject("Пол"));
+        floor->getTransform()->setPosition(glm::vec3(0.0f, -2.0f, 0.0f));
+        floor->getTransform()->setScale(glm::vec3(10.0f, 1.1f, 10.0f));
         auto floorRenderer = floor->addComponent<MeshRenderer>();
         floorRenderer->setMesh(Mesh::createCube());
         floor->getComponent<MeshRenderer>()->getMesh()->render(); // Генерируем буферы
 
         // Создаем центральный куб
-        auto centerCube = std::make_unique<GameObject>("Центральный куб");
-        centerCube->getTransform()->position = glm::vec3(0.0f, 0.0f, 0.0f);
-        auto cubeRenderer = centerCube->addComponent<MeshRenderer>();
+        centerCube = scene.createGameObject("Центральный куб");
+        GameObject* cube = scene.resolve(centerCube);
+        cube->getTransform()->setPosition(glm::vec3(0.0f, 0.0f, 0.0f));
+        auto cubeRenderer = cube->addComponent<MeshRenderer>();
         cubeRenderer->setMesh(Mesh::createCube());
-        centerCube->getComponent<MeshRenderer>()->getMesh()->render();
+        cube->getComponent<MeshRenderer>()->getMesh()->render();
+
+        // Создаем несколько объектов вокруг (экземпляры одного префаба с общим мешем)
+        Prefab orbiter("Объект");
+        orbiter.addComponent<Bobbing>();
+        orbiter.addComponent<MeshRenderer>(Mesh::createCube()).getMesh()->render();
 
-        // Создаем несколько объектов вокруг
-        for (int i = 0; i < 5; i++) {
+        PrefabSpawnOptions spawn;
+        spawn.setup = [](GameObject& obj, size_t i) {
             float angle = (float)i * glm::radians(72.0f);
             float radius = 3.0f;
 
-            auto obj = std::make_unique<GameObject>("Объект " + std::to_string(i + 1));
-            obj->getTransform()->position = glm::vec3(
+            obj.setName("Объект " + std::to_string(i + 1));
+            obj.getTransform()->setPosition(glm::vec3(
                 cos(angle) * radius,
                 0.0f,
                 sin(angle) * radius
-            );
-            obj->getTransform()->scale = glm::vec3(0.5f, 1.0f + i * 0.2f, 0.5f);
+            ));
+            obj.getTransform()->setScale(glm::vec3(0.5f, 1.0f + i * 0.2f, 0.5f));
 
-            auto renderer = obj->addComponent<MeshRenderer>();
-            renderer->setMesh(Mesh::createCube());
-            obj->getComponent<MeshRenderer>()->getMesh()->render();
-
-            gameObjects.push_back(std::move(obj));
-        }
-
-        gameObjects.push_back(std::move(floor));
-        gameObjects.push_back(std::move(centerCube));
+            Bobbing* bobbing = obj.getComponent<Bobbing>();
+            bobbing->phase = static_cast<float>(i);
+            bobbing->spinSpeed = 30.0f * (i + 1);
+            };
+        orbiter.instantiate(scene, 5, spawn);
 
         // ==================== Настройка callback'ов ====================
         core.setKeyCallback([&](int key, int action) {
@@ -93,20 +137,26 @@ public:
             onResize(width, height);
             });
 
+        core.getSystemScheduler()->addSystem<BobbingSystem>();
+
         core.setUpdateCallback([&](float deltaTime) {
             onUpdate(deltaTime);
             });
 
-        // Добавляем рендер-коллбэк
-        core.addRenderCallback([&]() {
-            onRender();
-            });
-
-        // ==================== Инициализация объектов ====================
-        for (auto& obj : gameObjects) {
-            obj->start();
+        // Добавляем рендер-коллбэк (в конвейерном режиме объекты попадают в снимок кадра)
+        if (config.pipelinedRendering) {
+            core.addSnapshotCallback([&](FrameSnapshot& frame) {
+                onSubmit(frame);
+                });
+        }
+        else {
+            core.addRenderCallback([&]() {
+                onRender();
+                });
         }
 
+        // Компоненты уже запущены при добавлении (addComponent вызывает start)
+
         LOG_INFO("=== Запуск главного цикла ===");
         core.run();
         LOG_INFO("=== Главный цикл завершен ===");
@@ -144,40 +194,36 @@ private:
     }
 
     void onUpdate(float deltaTime) {
-        static float time = 0.0f;
-        time += deltaTime;
+        // Обновление компонентов (заодно сохраняет предыдущее состояние Transform для интерполяции),
+        // затем системы
+        Core& core = Core::getInstance();
+        if (Camera* camera = core.getCamera()) {
+            scene.setRelevanceOrigin(camera->getPosition());
+        }
+        core.getSystemScheduler()->update(deltaTime, scene);
 
         // Вращаем центральный куб
-        if (gameObjects.size() > 1) {
-            auto& centerCube = gameObjects.back();
-            Transform* transform = centerCube->getTransform();
+        if (GameObject* cube = scene.resolve(centerCube)) {
+            Transform* transform = cube->getTransform();
             if (transform) {
                 transform->rotate(45.0f * deltaTime, glm::vec3(0.0f, 1.0f, 0.0f));
                 transform->rotate(20.0f * deltaTime, glm::vec3(1.0f, 0.0f, 0.0f));
             }
         }
-
-        // Плавное движение объектов вокруг
-        for (size_t i = 0; i < gameObjects.size() - 2; i++) { // -2 чтобы исключить пол и центральный куб
-            auto& obj = gameObjects[i];
-            Transform* transform = obj->getTransform();
-            if (transform) {
-                transform->position.y = sinf(time + i) * 0.5f;
-                transform->rotate(30.0f * deltaTime * (i + 1), glm::vec3(0.0f, 1.0f, 0.0f));
-            }
-        }
     }
 
     void onRender() {
-        // Рендеринг всех объектов
-        for (auto& obj : gameObjects) {
-            if (obj->isActive()) {
-                obj->render();
-            }
-        }
+        // Рендеринг всех объектов сцены
+        scene.render();
+    }
+
+    void onSubmit(FrameSnapshot& frame) {
+        // Заполнение снимка кадра для потока рендеринга
+        scene.submit(frame);
     }
 
-    std::vector<std::unique_ptr<GameObject>> gameObjects;
+    Scene scene{ "Основная сцена" };
+    EntityHandle centerCube;
 };
 
 int main() {
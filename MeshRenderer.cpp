@@ -1,5 +1,6 @@
 #include "MeshRenderer.h"
 #include "GameObject.h"
+#include "FramePipeline.h"
 #include <iostream>
 
 // ==================== Реализация класса Mesh ====================
@@ -78,6 +79,7 @@ void Mesh::render() const {
     if (VAO == 0) return;  // Проверка на инициализацию
 
     glBindVertexArray(VAO);  // Привязываем VAO для отрисовки
+    drawCallCount.fetch_add(1, std::memory_order_relaxed);
 
     if (indexCount > 0) {
         // Отрисовка с использованием индексов
@@ -268,6 +270,7 @@ void main() {
 // Отрисовка компонента MeshRenderer
 void MeshRenderer::render() {
     // Проверка необходимых условий для рендеринга
+    GameObject* gameObject = getGameObject();
     if (!mesh || !gameObject || !shaderProgram) return;
 
     // Получаем Transform компонент игрового объекта
@@ -282,22 +285,39 @@ void MeshRenderer::render() {
     // Активируем шейдерную программу
     shaderProgram->use();
 
-    // Получаем матрицу модели из Transform компонента
-    glm::mat4 model = transform->getModelMatrix();
+    // Получаем матрицу модели из Transform компонента (между двумя шагами симуляции)
+    glm::mat4 model = transform->getInterpolatedModelMatrix(core.getInterpolationAlpha());
 
     // Получаем матрицы вида и проекции из камеры
     glm::mat4 view = camera->getViewMatrix();  // Матрица вида камеры
 
     // Получаем соотношение сторон окна для расчета проекции
-    Core::Config config = core.getConfig();
+    const Core::Config& config = core.getConfig();
     float aspectRatio = static_cast<float>(config.width) / static_cast<float>(config.height);
     glm::mat4 projection = camera->getProjectionMatrix(aspectRatio);  // Матрица проекции
 
     // Устанавливаем uniform-переменные в шейдере
     shaderProgram->setMat4("model", model);          // Матрица модели
+    if (shaderProgram->hasUniform("normalMatrix")) {
+        shaderProgram->setMat3("normalMatrix", transform->getInterpolatedNormalMatrix(core.getInterpolationAlpha()));
+    }
     shaderProgram->setMat4("view", view);           // Матрица вида
     shaderProgram->setMat4("projection", projection); // Матрица проекции
 
     // Отрисовываем меш
     mesh->render();
-}
\ No newline at end of file
+}
+
+// Добавление объекта в снимок кадра для потока рендеринга
+void MeshRenderer::submit(FrameSnapshot& frame) {
+    GameObject* gameObject = getGameObject();
+    if (!mesh || !gameObject || !shaderProgram) return;
+
+    Transform* transform = gameObject->getComponent<Transform>();
+    if (!transform) return;
+
+    // Матрицы вида и проекции уже в снимке - сохраняем только данные объекта
+    float alpha = Core::getInstance().getInterpolationAlpha();
+    frame.items.push_back({ transform->getInterpolatedModelMatrix(alpha), transform->getInterpolatedNormalMatrix(alpha),
+        mesh.get(), shaderProgram.get() });
+}
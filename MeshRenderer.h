@@ -9,6 +9,7 @@
 #include <glm/gtc/type_ptr.hpp>          // Функции для преобразования GLM типов в указатели
 #include <vector>
 #include <memory>
+#include <atomic>
 
 #include "Core.h"
 #include "Camera.h"
@@ -60,6 +61,9 @@ public:
     unsigned int getVertexCount() const { return vertexCount; }  // Количество вершин
     unsigned int getIndexCount() const { return indexCount; }    // Количество индексов
 
+    // Количество вызовов отрисовки с прошлого запроса (счетчик обнуляется)
+    static unsigned int takeDrawCallCount() { return drawCallCount.exchange(0, std::memory_order_relaxed); }
+
 private:
     // Идентификаторы OpenGL объектов
     unsigned int VAO = 0;      // Vertex Array Object (хранит конфигурацию атрибутов)
@@ -70,6 +74,9 @@ private:
     unsigned int vertexCount = 0;  // Общее количество вершин
     unsigned int indexCount = 0;   // Общее количество индексов (0 если рисуем без индексов)
 
+    // Вызовы отрисовки за кадр (для счетчика в трассе профилировщика)
+    inline static std::atomic<unsigned int> drawCallCount{ 0 };
+
     // Настройка меша: создание и конфигурация буферов OpenGL
     void setupMesh(const std::vector<Vertex>& vertices,
         const std::vector<unsigned int>& indices);
@@ -85,6 +92,7 @@ public:
     // Методы жизненного цикла компонента
     void start() override;  // Инициализация (вызывается один раз)
     void render() override; // Отрисовка (вызывается каждый кадр)
+    void submit(FrameSnapshot& frame) override; // Добавление в снимок кадра (конвейерный рендеринг)
 
     // Сеттеры и геттеры
     void setMesh(std::shared_ptr<Mesh> newMesh) { mesh = newMesh; }
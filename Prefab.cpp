@@ -0,0 +1,74 @@
+#include "Prefab.h"
+#include "Scene.h"
+#include "Profiler.h"
+
+Prefab::Prefab(const std::string& name) : name(name) {
+}
+
+Prefab::~Prefab() = default;
+
+std::unique_ptr<GameObject> Prefab::createInstance() const {
+    auto object = std::make_unique<GameObject>(name);
+
+    Transform* instanceTransform = object->getTransform();
+    instanceTransform->setPosition(transform.getPosition());
+    instanceTransform->setRotation(transform.getRotation());
+    instanceTransform->setScale(transform.getScale());
+
+    for (const Entry& entry : entries) {
+        entry.clone(*object, *entry.prototype);
+    }
+    return object;
+}
+
+// ==================== Создание экземпляров ====================
+std::vector<EntityHandle> Prefab::instantiate(Scene& scene, size_t count, const PrefabSpawnOptions& options) const {
+    PROFILE_SCOPE("Prefab::instantiate");
+
+    std::vector<EntityHandle> handles;
+    if (count == 0) return handles;
+
+    // Память под всю партию выделяется сразу, а не новым слабом при каждом исчерпании пула
+    GameObject::reservePool(count);
+    if (GameObject::getDefaultStorage() == ComponentStorage::Heap) {
+        GameObject::reserveComponents<Transform>(count);
+        for (const Entry& entry : entries) {
+            if (entry.reserve) entry.reserve(count);
+        }
+    }
+
+    // Копии прототипов без start: setup успевает настроить компоненты до запуска
+    std::vector<std::unique_ptr<GameObject>> instances;
+    instances.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        instances.push_back(createInstance());
+        if (options.setup) {
+            options.setup(*instances.back(), i);
+        }
+    }
+
+    // Сначала в сцену: активность экземпляра зависит от родителя
+    std::vector<GameObject*> added;
+    added.reserve(count);
+    scene.reserve(count);
+    handles.reserve(count);
+    for (auto& instance : instances) {
+        added.push_back(instance.get());
+        handles.push_back(instance->getHandle());
+        scene.addGameObject(std::move(instance), options.parent);
+    }
+
+    // start всех экземпляров одним проходом. Под неактивным родителем start не вызывается
+    for (GameObject* object : added) {
+        if (object->isActive()) {
+            object->startComponents();
+        }
+    }
+    return handles;
+}
+
+EntityHandle Prefab::instantiate(Scene& scene, EntityHandle parent) const {
+    PrefabSpawnOptions options;
+    options.parent = parent;
+    return instantiate(scene, 1, options).front();
+}
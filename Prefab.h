@@ -0,0 +1,94 @@
+#pragma once
+#include "GameObject.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <type_traits>
+#include <vector>
+
+class Scene;
+
+// ==================== Параметры создания экземпляров ====================
+struct PrefabSpawnOptions {
+    EntityHandle parent;                                    // Родитель экземпляров (нулевой - корневые объекты)
+    std::function<void(GameObject&, size_t)> setup;         // Настройка экземпляра i до вызова start
+};
+
+// ==================== Префаб ====================
+// Шаблон объекта: набор компонентов-прототипов с начальными значениями и Transform.
+// instantiate создает count экземпляров за один вызов: память пулов выделяется заранее на всю
+// партию, компоненты копируются из прототипов без вызова start, экземпляры добавляются в сцену
+// под родителя, затем start вызывается одним проходом у тех, что активны в иерархии.
+// start - в вызывающем потоке: компоненты создают в нем ресурсы GPU (MeshRenderer компилирует
+// шейдер) и им нужен текущий контекст OpenGL. В режиме Archetype во время обхода сцены
+// компоненты не добавляются (ArchetypeStorage::StructuralLock) - создание откладывается через CommandBuffer
+class Prefab {
+public:
+    explicit Prefab(const std::string& name = "GameObject");
+    ~Prefab();
+
+    Prefab(const Prefab&) = delete;
+    Prefab& operator=(const Prefab&) = delete;
+
+    // Добавление компонента-прототипа. Экземпляры получают его копию
+    template<typename T, typename... Args>
+    T& addComponent(Args&&... args) {
+        static_assert(std::is_base_of<Component, T>::value, "T должен наследоваться от Component");
+        static_assert(std::is_copy_constructible<T>::value, "Компонент префаба копируется в экземпляры");
+        static_assert(!std::is_same<T, Transform>::value, "Transform префаба задается через getTransform()");
+
+        auto prototype = std::make_unique<T>(std::forward<Args>(args)...);
+        T* ptr = prototype.get();
+
+        Entry& entry = entries.emplace_back();
+        entry.prototype = std::move(prototype);
+        entry.clone = [](GameObject& object, const Component& source) -> Component* {
+            return object.emplaceComponent<T>(static_cast<const T&>(source));
+        };
+        if constexpr (isRegisteredComponent<T>) {
+            entry.reserve = [](size_t count) { GameObject::reserveComponents<T>(count); };
+        }
+        return *ptr;
+    }
+
+    // Прототип компонента (nullptr, если тип не добавлен)
+    template<typename T>
+    T* getComponent() {
+        for (Entry& entry : entries) {
+            if (T* component = dynamic_cast<T*>(entry.prototype.get())) {
+                return component;
+            }
+        }
+        return nullptr;
+    }
+
+    // Начальные position / rotation / scale экземпляров
+    Transform& getTransform() { return transform; }
+    const Transform& getTransform() const { return transform; }
+
+    const std::string& getName() const { return name; }
+    void setName(const std::string& value) { name = value; }
+    size_t getComponentCount() const { return entries.size(); }
+
+    // Создание count экземпляров в сцене. Возвращает их дескрипторы в порядке создания
+    std::vector<EntityHandle> instantiate(Scene& scene, size_t count,
+        const PrefabSpawnOptions& options = PrefabSpawnOptions()) const;
+
+    // Один экземпляр
+    EntityHandle instantiate(Scene& scene, EntityHandle parent = EntityHandle()) const;
+
+private:
+    struct Entry {
+        std::unique_ptr<Component> prototype;
+        Component* (*clone)(GameObject& object, const Component& source) = nullptr;
+        void (*reserve)(size_t count) = nullptr;   // Только для типов с REGISTER_COMPONENT
+    };
+
+    std::unique_ptr<GameObject> createInstance() const;
+
+    std::string name;
+    Transform transform;
+    std::vector<Entry> entries;
+};
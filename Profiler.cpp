@@ -0,0 +1,451 @@
+#include "Profiler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    // Состояние текущего потока: буфер событий и стек открытых зон
+    struct ThreadState {
+        void* buffer = nullptr;
+        uint64_t zoneStack[Profiler::MaxDepth] = {};
+        uint32_t depth = 0;
+    };
+
+    thread_local ThreadState threadState;
+
+    double toMilliseconds(uint64_t nanoseconds) {
+        return static_cast<double>(nanoseconds) / 1'000'000.0;
+    }
+
+    // Экранирование строки для JSON (имена зон и потоков)
+    std::string escapeJson(const char* text) {
+        std::string result;
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') result += '\\';
+            if (static_cast<unsigned char>(*c) >= 0x20) result += *c;
+        }
+        return result;
+    }
+}
+
+std::atomic<bool> Profiler::enabled{ true };
+std::atomic<bool> Profiler::capturing{ false };
+
+uint64_t Profiler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ==================== Потоки ====================
+Profiler::ThreadBuffer* Profiler::getThreadBuffer() {
+    if (threadState.buffer) {
+        return static_cast<ThreadBuffer*>(threadState.buffer);
+    }
+
+    // Регистрация - один раз на поток. Буферы живут до конца программы,
+    // поэтому события завершившегося потока все равно будут собраны
+    ThreadBuffer* buffer = registerBuffer("");
+    threadState.buffer = buffer;
+    return buffer;
+}
+
+Profiler::ThreadBuffer* Profiler::registerBuffer(const std::string& name) {
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->index = static_cast<uint32_t>(threads.size());
+    buffer->name = name.empty() ? "Поток " + std::to_string(buffer->index) : name;
+    threads.push_back(std::move(buffer));
+    return threads.back().get();
+}
+
+uint32_t Profiler::createTrack(const std::string& name) {
+    return registerBuffer(name)->index;
+}
+
+// Идентификатор зоны зависит от имени, родителя и дорожки:
+// одна и та же функция под разными родителями - разные узлы дерева
+uint64_t Profiler::makeRootId(uint32_t threadIndex) {
+    return (static_cast<uint64_t>(threadIndex) + 1) * 0x9E3779B97F4A7C15ull;
+}
+
+uint64_t Profiler::makeZoneId(uint64_t parentId, const char* name) {
+    uint64_t zoneId = (parentId ^ reinterpret_cast<uintptr_t>(name)) * 0x100000001B3ull;
+    return zoneId != 0 ? zoneId : 1;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer* buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    buffer->name = name;
+}
+
+// ==================== Зоны ====================
+bool Profiler::beginZone(const char* name, ProfileEvent& event) {
+    ThreadBuffer* buffer = getThreadBuffer();
+    if (threadState.depth >= MaxDepth) return false;
+
+    uint64_t parentId = threadState.depth > 0
+        ? threadState.zoneStack[threadState.depth - 1]
+        : makeRootId(buffer->index);
+    uint64_t zoneId = makeZoneId(parentId, name);
+
+    event.name = name;
+    event.zoneId = zoneId;
+    event.parentId = threadState.depth > 0 ? parentId : 0;
+    event.depth = threadState.depth;
+
+    threadState.zoneStack[threadState.depth++] = zoneId;
+    event.start = now();
+    return true;
+}
+
+void Profiler::endZone(ProfileEvent& event) {
+    event.end = now();
+    --threadState.depth;
+    pushEvent(event);
+}
+
+void Profiler::pushEvent(const ProfileEvent& event) {
+    pushEvent(getThreadBuffer(), event);
+}
+
+void Profiler::pushEvent(ThreadBuffer* buffer, const ProfileEvent& event) {
+    if (!buffer->events.tryPush(event)) {
+        // Буфер не успели собрать - событие теряется, но поток не блокируется
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Profiler::recordZone(uint32_t track, const char* name, uint64_t start, uint64_t end, uint32_t depth) {
+    if (depth >= MaxDepth) return;
+
+    ThreadBuffer* buffer;
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        if (track >= threads.size()) return;
+        buffer = threads[track].get();
+    }
+
+    uint64_t parentId = depth > 0 ? buffer->zoneStack[depth - 1] : makeRootId(track);
+    ProfileEvent event;
+    event.name = name;
+    event.zoneId = makeZoneId(parentId, name);
+    event.parentId = depth > 0 ? parentId : 0;
+    event.start = start;
+    event.end = end;
+    event.depth = depth;
+    buffer->zoneStack[depth] = event.zoneId;
+
+    pushEvent(buffer, event);
+}
+
+// ==================== События трассы ====================
+void Profiler::flowBegin(const char* name, uint64_t id) {
+    ProfileEvent event;
+    event.kind = ProfileEvent::Kind::FlowBegin;
+    event.name = name;
+    event.zoneId = id;
+    event.start = event.end = now();
+    pushEvent(event);
+}
+
+void Profiler::flowEnd(const char* name, uint64_t id) {
+    ProfileEvent event;
+    event.kind = ProfileEvent::Kind::FlowEnd;
+    event.name = name;
+    event.zoneId = id;
+    event.start = event.end = now();
+    pushEvent(event);
+}
+
+void Profiler::counter(const char* name, double value) {
+    ProfileEvent event;
+    event.kind = ProfileEvent::Kind::Counter;
+    event.name = name;
+    event.value = value;
+    event.start = event.end = now();
+    pushEvent(event);
+}
+
+// ==================== Захват трассы ====================
+bool Profiler::startCapture(const std::string& path) {
+    if (traceFile.is_open()) {
+        LOG_WARNING("Захват трассы уже идет: %s", tracePath.c_str());
+        return false;
+    }
+
+    traceFile.open(path, std::ios::out | std::ios::trunc);
+    if (!traceFile.is_open()) {
+        LOG_ERROR("Не удалось открыть файл трассы: %s", path.c_str());
+        return false;
+    }
+
+    tracePath = path;
+    traceStart = now();
+    traceFirstEvent = true;
+    traceFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    capturing.store(true, std::memory_order_relaxed);
+
+    LOG_INFO("Захват трассы начат: %s", path.c_str());
+    return true;
+}
+
+void Profiler::stopCapture() {
+    captureArmed = false;
+    if (!traceFile.is_open()) return;
+
+    // Забираем события, накопленные с последнего кадра
+    drainEvents();
+    capturing.store(false, std::memory_order_relaxed);
+
+    // Имена дорожек потоков
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (const auto& thread : threads) {
+            traceFile << (traceFirstEvent ? "" : ",\n")
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->index
+                << ",\"args\":{\"name\":\"" << escapeJson(thread->name.c_str()) << "\"}}";
+            traceFirstEvent = false;
+        }
+    }
+
+    traceFile << "\n]}\n";
+    traceFile.close();
+    LOG_INFO("Захват трассы завершен: %s", tracePath.c_str());
+}
+
+void Profiler::captureFrames(const std::string& path, uint64_t firstFrame, uint64_t frameCount,
+    uint64_t currentFrame) {
+    if (frameCount == 0) return;
+
+    tracePath = path;
+    captureFirstFrame = firstFrame;
+    captureEndFrame = firstFrame + frameCount;
+    captureArmed = true;
+
+    // Диапазон уже начался - захватываем с текущего кадра
+    if (firstFrame <= currentFrame) {
+        captureArmed = startCapture(path);
+    }
+}
+
+void Profiler::writeTraceEvent(const ProfileEvent& event, uint32_t threadIndex) {
+    // События, завершившиеся до начала захвата, в трассу не попадают
+    if (event.end < traceStart) return;
+
+    // Время в трассе - микросекунды от начала захвата
+    double timestamp = static_cast<double>(event.start > traceStart ? event.start - traceStart : 0) / 1000.0;
+    std::string name = escapeJson(event.name ? event.name : "");
+
+    char line[512];
+    int length = 0;
+    switch (event.kind) {
+    case ProfileEvent::Kind::Zone:
+        length = std::snprintf(line, sizeof(line),
+            "{\"name\":\"%s\",\"cat\":\"engine\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+            name.c_str(), timestamp, static_cast<double>(event.end - event.start) / 1000.0, threadIndex);
+        break;
+    case ProfileEvent::Kind::FlowBegin:
+        length = std::snprintf(line, sizeof(line),
+            "{\"name\":\"%s\",\"cat\":\"flow\",\"ph\":\"s\",\"id\":%llu,\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+            name.c_str(), static_cast<unsigned long long>(event.zoneId), timestamp, threadIndex);
+        break;
+    case ProfileEvent::Kind::FlowEnd:
+        // bp:e - связь привязывается к зоне, внутри которой находится событие
+        length = std::snprintf(line, sizeof(line),
+            "{\"name\":\"%s\",\"cat\":\"flow\",\"ph\":\"f\",\"bp\":\"e\",\"id\":%llu,\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+            name.c_str(), static_cast<unsigned long long>(event.zoneId), timestamp, threadIndex);
+        break;
+    case ProfileEvent::Kind::Counter:
+        length = std::snprintf(line, sizeof(line),
+            "{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%g}}",
+            name.c_str(), timestamp, threadIndex, event.value);
+        break;
+    }
+
+    if (length <= 0 || length >= static_cast<int>(sizeof(line))) return;
+
+    if (!traceFirstEvent) traceFile.write(",\n", 2);
+    traceFile.write(line, length);
+    traceFirstEvent = false;
+}
+
+// ==================== Кадр ====================
+void Profiler::endFrame(uint64_t frameIndex) {
+    drainEvents();
+
+    // Закрываем кадр: время каждой встреченной зоны уходит в историю
+    for (auto& [id, zone] : zones) {
+        zone.lastCalls = zone.frameCalls;
+        if (zone.frameCalls == 0) continue;
+
+        zone.history[zone.historyPos] = zone.frameTime;
+        zone.historyPos = (zone.historyPos + 1) % HistorySize;
+        if (zone.historyCount < HistorySize) ++zone.historyCount;
+
+        zone.frameTime = 0;
+        zone.frameCalls = 0;
+    }
+
+    // Захват диапазона кадров: следующий кадр - первый или уже за пределами диапазона
+    uint64_t nextFrame = frameIndex + 1;
+    if (captureArmed) {
+        if (!traceFile.is_open() && nextFrame == captureFirstFrame) {
+            captureArmed = startCapture(tracePath);
+        }
+        else if (traceFile.is_open() && nextFrame >= captureEndFrame) {
+            stopCapture();
+        }
+    }
+}
+
+void Profiler::drainEvents() {
+    drainBuffer.resize(EventBufferSize);
+
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (auto& thread : threads) {
+            size_t count = thread->events.popBatch(drainBuffer.data(), drainBuffer.size());
+
+            for (size_t i = 0; i < count; ++i) {
+                const ProfileEvent& event = drainBuffer[i];
+                if (traceFile.is_open()) {
+                    writeTraceEvent(event, thread->index);
+                }
+                if (event.kind != ProfileEvent::Kind::Zone) continue;
+
+                ZoneStats& zone = zones[event.zoneId];
+                if (!zone.name) {
+                    zone.name = event.name;
+                    zone.parentId = event.parentId;
+                    zone.depth = event.depth;
+                    zone.threadIndex = thread->index;
+                }
+                zone.frameTime += event.end - event.start;
+                ++zone.frameCalls;
+            }
+
+            uint64_t dropped = thread->dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped > 0) {
+                LOG_WARNING("Профилировщик: буфер потока '%s' переполнен, потеряно событий: %llu",
+                    thread->name.c_str(), static_cast<unsigned long long>(dropped));
+            }
+        }
+    }
+}
+
+// ==================== Отчеты ====================
+std::vector<ProfileZoneReport> Profiler::getReport() const {
+    std::vector<ProfileZoneReport> report;
+
+    std::vector<std::string> threadNames;
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (const auto& thread : threads) {
+            threadNames.push_back(thread->name);
+        }
+    }
+
+    // Статистика по каждой зоне
+    struct Node {
+        uint64_t id;
+        uint64_t parentId;
+        uint32_t threadIndex;
+        ProfileZoneReport stats;
+    };
+    std::vector<Node> nodes;
+    std::vector<uint64_t> samples;
+
+    for (const auto& [id, zone] : zones) {
+        if (zone.historyCount == 0) continue;
+
+        samples.assign(zone.history.begin(), zone.history.begin() + zone.historyCount);
+
+        ProfileZoneReport stats;
+        stats.name = zone.name;
+        stats.threadName = zone.threadIndex < threadNames.size() ? threadNames[zone.threadIndex] : "";
+        stats.depth = zone.depth;
+        stats.calls = zone.lastCalls;
+        stats.frames = zone.historyCount;
+        stats.lastMs = toMilliseconds(zone.history[(zone.historyPos + HistorySize - 1) % HistorySize]);
+
+        uint64_t total = 0;
+        for (uint64_t sample : samples) total += sample;
+        auto [minIt, maxIt] = std::minmax_element(samples.begin(), samples.end());
+        stats.minMs = toMilliseconds(*minIt);
+        stats.maxMs = toMilliseconds(*maxIt);
+        stats.avgMs = toMilliseconds(total) / static_cast<double>(samples.size());
+
+        size_t p99Index = (samples.size() * 99 + 99) / 100 - 1;
+        std::nth_element(samples.begin(), samples.begin() + p99Index, samples.end());
+        stats.p99Ms = toMilliseconds(samples[p99Index]);
+
+        nodes.push_back({ id, zone.parentId, zone.threadIndex, std::move(stats) });
+    }
+
+    // Обход дерева: корни по потокам, дети по убыванию среднего времени
+    std::sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) {
+        if (a.threadIndex != b.threadIndex) return a.threadIndex < b.threadIndex;
+        return a.stats.avgMs > b.stats.avgMs;
+        });
+
+    std::unordered_map<uint64_t, size_t> nodeById;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        nodeById[nodes[i].id] = i;
+    }
+
+    // Зона без родителя в статистике (например, родитель еще ни разу не завершился) - корень
+    std::unordered_map<uint64_t, std::vector<size_t>> children;
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].parentId == 0 || nodeById.find(nodes[i].parentId) == nodeById.end()) {
+            roots.push_back(i);
+        }
+        else {
+            children[nodes[i].parentId].push_back(i);
+        }
+    }
+
+    std::vector<size_t> stack(roots.rbegin(), roots.rend());
+    while (!stack.empty()) {
+        size_t index = stack.back();
+        stack.pop_back();
+        report.push_back(nodes[index].stats);
+
+        auto it = children.find(nodes[index].id);
+        if (it != children.end()) {
+            stack.insert(stack.end(), it->second.rbegin(), it->second.rend());
+        }
+    }
+
+    return report;
+}
+
+void Profiler::logReport() const {
+    std::vector<ProfileZoneReport> report = getReport();
+    if (report.empty()) {
+        LOG_INFO("Профилировщик: нет данных");
+        return;
+    }
+
+    LOG_INFO("==================== Профиль кадра (мс) ====================");
+    LOG_INFO("%-40s %7s %7s %7s %7s %7s %5s", "Зона", "посл.", "мин", "сред", "макс", "p99", "вызов");
+
+    std::string lastThread;
+    for (const auto& zone : report) {
+        if (zone.depth == 0 && zone.threadName != lastThread) {
+            LOG_INFO("[%s]", zone.threadName.c_str());
+            lastThread = zone.threadName;
+        }
+
+        std::string name(zone.depth * 2, ' ');
+        name += zone.name;
+        LOG_INFO("%-40s %7.3f %7.3f %7.3f %7.3f %7.3f %5u", name.c_str(),
+            zone.lastMs, zone.minMs, zone.avgMs, zone.maxMs, zone.p99Ms, zone.calls);
+    }
+}
+
+void Profiler::resetStatistics() {
+    zones.clear();
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include "SpscRingBuffer.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ==================== Событие профилировщика ====================
+// Одно событие на одном потоке. Имя - строковый литерал (указатель хранится без копирования)
+struct ProfileEvent {
+    enum class Kind : uint8_t {
+        Zone,           // Завершенная зона
+        FlowBegin,      // Начало связи между потоками (zoneId - идентификатор связи)
+        FlowEnd,        // Конец связи
+        Counter         // Значение счетчика (value)
+    };
+
+    const char* name = nullptr;
+    uint64_t zoneId = 0;        // Идентификатор зоны с учетом пути в иерархии
+    uint64_t parentId = 0;      // Идентификатор родительской зоны (0 - корень)
+    uint64_t start = 0;         // Время начала, нс
+    uint64_t end = 0;           // Время окончания, нс
+    double value = 0.0;
+    uint32_t depth = 0;         // Глубина вложенности
+    Kind kind = Kind::Zone;
+};
+
+// ==================== Статистика зоны ====================
+// Время зоны за кадр (сумма всех вызовов) по последним HistorySize кадрам
+struct ProfileZoneReport {
+    const char* name = nullptr;
+    std::string threadName;
+    uint32_t depth = 0;
+    uint32_t calls = 0;         // Вызовов в последнем кадре
+    size_t frames = 0;          // Кадров в статистике
+    double lastMs = 0.0;
+    double minMs = 0.0;
+    double avgMs = 0.0;
+    double maxMs = 0.0;
+    double p99Ms = 0.0;
+};
+
+// ==================== Профилировщик ====================
+// Иерархический профилировщик CPU. Каждый поток пишет события в собственный
+// кольцевой буфер без блокировок; главный поток раз в кадр (endFrame) забирает
+// события всех потоков и сводит их в статистику по зонам
+class Profiler {
+public:
+    static constexpr size_t EventBufferSize = 8192;    // Событий на поток между вызовами endFrame
+    static constexpr size_t HistorySize = 128;         // Кадров в статистике
+    static constexpr uint32_t MaxDepth = 64;           // Максимальная глубина вложенности зон
+
+    static Profiler& getInstance() {
+        static Profiler instance;
+        return instance;
+    }
+
+    // Запрещаем копирование
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // ==================== Управление ====================
+    static void setEnabled(bool value) { enabled.store(value, std::memory_order_relaxed); }
+    // Зоны пишутся, если включена статистика или идет захват трассы
+    static bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed) || capturing.load(std::memory_order_relaxed);
+    }
+    static bool isCapturing() { return capturing.load(std::memory_order_relaxed); }
+
+    // Имя текущего потока в отчетах
+    void setThreadName(const std::string& name);
+
+    // Текущее время, нс
+    static uint64_t now();
+
+    // ==================== Зоны ====================
+    // Используются через PROFILE_SCOPE; beginZone возвращает false, если зона не записывается
+    bool beginZone(const char* name, ProfileEvent& event);
+    void endZone(ProfileEvent& event);
+
+    // ==================== Внешние дорожки ====================
+    // Дорожка для зон, измеренных не на CPU (например, GPU). В дорожку пишет один поток за раз
+    uint32_t createTrack(const std::string& name);
+    // Зона с известным временем (нс, по часам now()). Зоны передаются в порядке начала:
+    // родитель - перед детьми, depth - глубина вложенности
+    void recordZone(uint32_t track, const char* name, uint64_t start, uint64_t end, uint32_t depth);
+
+    // ==================== События трассы ====================
+    // Записываются только во время захвата
+    void flowBegin(const char* name, uint64_t id);     // Связь между стадиями (например, кадр N: симуляция -> рендеринг)
+    void flowEnd(const char* name, uint64_t id);
+    void counter(const char* name, double value);       // Дорожка счетчика (FPS, вызовы отрисовки)
+
+    // ==================== Захват трассы ====================
+    // События потоком пишутся в JSON формата Chrome Trace Event
+    // (открывается в chrome://tracing и ui.perfetto.dev)
+    bool startCapture(const std::string& path);
+    void stopCapture();
+    // Захват кадров [firstFrame, firstFrame + frameCount); currentFrame - текущий кадр движка
+    void captureFrames(const std::string& path, uint64_t firstFrame, uint64_t frameCount,
+        uint64_t currentFrame);
+
+    // ==================== Кадр ====================
+    // Собрать события всех потоков и закрыть статистику кадра frameIndex (вызывается из Core)
+    void endFrame(uint64_t frameIndex);
+
+    // ==================== Отчеты ====================
+    // Зоны в порядке иерархии (дети сразу после родителя, по убыванию среднего времени)
+    std::vector<ProfileZoneReport> getReport() const;
+    void logReport() const;
+    void resetStatistics();
+
+private:
+    Profiler() = default;
+
+    // Буфер событий одного потока (писатель - сам поток, читатель - endFrame)
+    struct ThreadBuffer {
+        SpscRingBuffer<ProfileEvent, EventBufferSize> events;
+        std::string name;
+        uint32_t index = 0;
+        std::atomic<uint64_t> dropped{ 0 };
+        uint64_t zoneStack[MaxDepth] = {};     // Последние зоны по глубине (только для внешних дорожек)
+    };
+
+    // Накопленная статистика зоны
+    struct ZoneStats {
+        const char* name = nullptr;
+        uint64_t parentId = 0;
+        uint32_t depth = 0;
+        uint32_t threadIndex = 0;
+        uint64_t frameTime = 0;        // Сумма за текущий кадр, нс
+        uint32_t frameCalls = 0;
+        uint32_t lastCalls = 0;
+        std::array<uint64_t, HistorySize> history{};
+        size_t historyCount = 0;
+        size_t historyPos = 0;
+    };
+
+    ThreadBuffer* getThreadBuffer();
+    ThreadBuffer* registerBuffer(const std::string& name);
+    void pushEvent(const ProfileEvent& event);
+    static void pushEvent(ThreadBuffer* buffer, const ProfileEvent& event);
+    static uint64_t makeZoneId(uint64_t parentId, const char* name);
+    static uint64_t makeRootId(uint32_t threadIndex);
+    void drainEvents();
+    void writeTraceEvent(const ProfileEvent& event, uint32_t threadIndex);
+
+    static std::atomic<bool> enabled;
+    static std::atomic<bool> capturing;
+
+    // Захват трассы (файл пишет только поток, вызывающий endFrame; stopCapture - с него же)
+    std::ofstream traceFile;
+    std::string tracePath;
+    uint64_t traceStart = 0;           // Начало захвата, нс (точка отсчета времени в трассе)
+    bool traceFirstEvent = true;
+    bool captureArmed = false;         // Ожидается захват диапазона кадров
+    uint64_t captureFirstFrame = 0;
+    uint64_t captureEndFrame = 0;
+
+    mutable std::mutex threadsMutex;       // Только регистрация потоков и сбор событий
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+
+    std::unordered_map<uint64_t, ZoneStats> zones;
+    std::vector<ProfileEvent> drainBuffer;
+};
+
+// ==================== Зона профилирования (RAII) ====================
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) {
+        active = Profiler::isEnabled() && Profiler::getInstance().beginZone(name, event);
+    }
+
+    ~ProfileScope() {
+        if (active) {
+            Profiler::getInstance().endZone(event);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    ProfileEvent event;
+    bool active = false;
+};
+
+// ==================== Макросы ====================
+// Имя зоны должно быть строковым литералом. ENGINE_DISABLE_PROFILING убирает зоны из сборки
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifndef ENGINE_DISABLE_PROFILING
+#define PROFILE_SCOPE(name)     ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION()      PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_FLOW_BEGIN(name, id) \
+    do { if (Profiler::isCapturing()) Profiler::getInstance().flowBegin(name, id); } while (0)
+#define PROFILE_FLOW_END(name, id) \
+    do { if (Profiler::isCapturing()) Profiler::getInstance().flowEnd(name, id); } while (0)
+#define PROFILE_COUNTER(name, value) \
+    do { if (Profiler::isCapturing()) Profiler::getInstance().counter(name, value); } while (0)
+#else
+#define PROFILE_SCOPE(name)     ((void)0)
+#define PROFILE_FUNCTION()      ((void)0)
+#define PROFILE_FLOW_BEGIN(name, id)    ((void)0)
+#define PROFILE_FLOW_END(name, id)      ((void)0)
+#define PROFILE_COUNTER(name, value)    ((void)0)
+#endif
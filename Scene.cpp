@@ -0,0 +1,500 @@
+#include "Scene.h"
+#include "CommandBuffer.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+
+Scene::Scene(const std::string& name) : name(name) {
+}
+
+Scene::~Scene() {
+    if (onUnload) onUnload(*this);
+
+    // Same cleanup as destroying the objects one by one (Component::onDestroy, listeners)
+    for (const auto& root : objects) {
+        unregisterSubtree(root.get());
+    }
+
+    // Roots destroy their subtrees; dense only holds non-owning pointers
+    dense.clear();
+    slots.clear();
+    objects.clear();
+}
+
+// ==================== Object management ====================
+EntityHandle Scene::createGameObject(const std::string& name) {
+    return createGameObject(name, EntityHandle());
+}
+
+EntityHandle Scene::createGameObject(const std::string& name, EntityHandle parent) {
+    if (runningSystems) {
+        CommandBuffer::getThreadBuffer().createGameObject(*this, name, parent);
+        return EntityHandle();
+    }
+    if (updating) {
+        auto object = std::make_unique<GameObject>(name);
+        EntityHandle handle = object->getHandle();
+        pendingObjects.push_back({ std::move(object), parent });
+        return handle;
+    }
+    if (parent.isNull()) {
+        auto object = std::make_unique<GameObject>(name);
+        EntityHandle handle = object->getHandle();
+        addGameObject(std::move(object));
+        return handle;
+    }
+
+    if (findDenseIndex(parent) == InvalidIndex) {
+        LOG_WARNING("Scene '%s': parent of '%s' is not in the scene, creating a root object",
+            this->name.c_str(), name.c_str());
+        return createGameObject(name);
+    }
+
+    GameObject* child = resolve(parent)->createChild(name);
+    registerSubtree(child);
+    componentCacheValid = false;
+    return child->getHandle();
+}
+
+void Scene::attachPendingObjects() {
+    // A pending parent was created earlier in the same step, so it is attached first
+    for (PendingObject& pending : pendingObjects) {
+        addGameObject(std::move(pending.object), pending.parent);
+    }
+    pendingObjects.clear();
+}
+
+void Scene::addGameObject(std::unique_ptr<GameObject> obj) {
+    if (!obj) return;
+
+    GameObject* object = obj.get();
+    registerSubtree(object);
+    slots[object->getHandle().index].root = static_cast<uint32_t>(objects.size());
+    objects.push_back(std::move(obj));
+    componentCacheValid = false;
+}
+
+void Scene::addGameObject(std::unique_ptr<GameObject> obj, EntityHandle parent) {
+    if (!obj) return;
+
+    if (parent.isNull() || findDenseIndex(parent) == InvalidIndex) {
+        if (!parent.isNull()) {
+            LOG_WARNING("Scene '%s': parent of '%s' is not in the scene, adding a root object",
+                name.c_str(), obj->getName().c_str());
+        }
+        addGameObject(std::move(obj));
+        return;
+    }
+
+    GameObject* object = obj.get();
+    resolve(parent)->addChild(std::move(obj));
+    registerSubtree(object);
+    componentCacheValid = false;
+}
+
+void Scene::reserve(size_t count) {
+    dense.reserve(dense.size() + count);
+    objects.reserve(objects.size() + count);
+}
+
+void Scene::destroyGameObject(EntityHandle handle) {
+    // Recorded even if the object is not in the scene yet: one created during update()
+    // is attached before the playback
+    if (isRecording()) {
+        CommandBuffer::getThreadBuffer().destroyGameObject(*this, handle);
+        return;
+    }
+    if (findDenseIndex(handle) == InvalidIndex) return;
+    destroyImmediate(handle);
+}
+
+void Scene::destroyImmediate(EntityHandle handle) {
+    // The handle may have died already (destroyed twice or together with an ancestor)
+    if (findDenseIndex(handle) == InvalidIndex) return;
+
+    GameObject* object = resolve(handle);
+    unregisterSubtree(object);
+    componentCacheValid = false;
+
+    uint32_t rootIndex = slots[handle.index].root;
+    slots[handle.index].root = InvalidIndex;
+
+    if (rootIndex == InvalidIndex) {
+        // Child: the parent owns it, the detached subtree dies at the end of the statement
+        object->getParent()->detachChild(object);
+        return;
+    }
+
+    // Root: swap-and-pop
+    uint32_t last = static_cast<uint32_t>(objects.size() - 1);
+    if (rootIndex != last) {
+        objects[rootIndex] = std::move(objects[last]);
+        slots[objects[rootIndex]->getHandle().index].root = rootIndex;
+    }
+    objects.pop_back();
+}
+
+bool Scene::setParent(EntityHandle child, EntityHandle newParent) {
+    if (isRecording()) {
+        CommandBuffer::getThreadBuffer().setParent(*this, child, newParent);
+        return true;
+    }
+    if (findDenseIndex(child) == InvalidIndex) return false;
+    if (!newParent.isNull() && findDenseIndex(newParent) == InvalidIndex) return false;
+
+    // The new parent must not be inside the moved subtree. Walks the live parent chain rather
+    // than the flattened order, which may be stale until the next rebuild
+    GameObject* object = resolve(child);
+    for (GameObject* ancestor = resolve(newParent); ancestor; ancestor = ancestor->getParent()) {
+        if (ancestor == object) {
+            LOG_WARNING("Scene '%s': cannot move '%s' under itself or its own descendant",
+                name.c_str(), object->getName().c_str());
+            return false;
+        }
+    }
+
+    // Take ownership from the current owner
+    std::unique_ptr<GameObject> owned;
+    uint32_t rootIndex = slots[child.index].root;
+    if (rootIndex == InvalidIndex) {
+        owned = object->getParent()->detachChild(object);
+    }
+    else {
+        uint32_t last = static_cast<uint32_t>(objects.size() - 1);
+        owned = std::move(objects[rootIndex]);
+        if (rootIndex != last) {
+            objects[rootIndex] = std::move(objects[last]);
+            slots[objects[rootIndex]->getHandle().index].root = rootIndex;
+        }
+        objects.pop_back();
+        slots[child.index].root = InvalidIndex;
+    }
+
+    if (newParent.isNull()) {
+        slots[child.index].root = static_cast<uint32_t>(objects.size());
+        objects.push_back(std::move(owned));
+    }
+    else {
+        resolve(newParent)->addChild(std::move(owned));
+    }
+
+    hierarchyDirty = true;
+    return true;
+}
+
+void Scene::setActive(EntityHandle handle, bool active) {
+    if (findDenseIndex(handle) == InvalidIndex) return;
+    resolve(handle)->setActive(active);
+}
+
+const SceneHierarchy& Scene::getHierarchy() {
+    // Not during update(): the walk holds indices into the current order
+    if (hierarchyDirty && !updating) {
+        hierarchy.rebuild(objects);
+        hierarchyDirty = false;
+        activeListsDirty = true;
+    }
+    return hierarchy;
+}
+
+const std::vector<GameObject*>& Scene::getActiveObjects() {
+    refreshActiveLists();
+    return activeObjects;
+}
+
+void Scene::refreshActiveLists() {
+    const SceneHierarchy& order = getHierarchy();
+    if (updating) return;
+
+    // Many changes at once: one full pass is cheaper than patching range by range
+    if (pendingListPatches.size() > std::max<size_t>(MinPatchRebuild, order.size() / 16)) {
+        activeListsDirty = true;
+    }
+
+    if (activeListsDirty) {
+        PROFILE_SCOPE("Scene::refreshActiveLists");
+        activeObjects.clear();
+        renderObjects.clear();
+        submitObjects.clear();
+        collectActiveRange(0, static_cast<uint32_t>(order.size()), activeObjects, renderObjects, submitObjects);
+
+        pendingListPatches.clear();
+        activeListsDirty = false;
+        return;
+    }
+    if (pendingListPatches.empty()) return;
+
+    PROFILE_SCOPE("Scene::patchActiveLists");
+    for (const ListPatch& patch : pendingListPatches) {
+        patchActiveLists(patch);
+    }
+    pendingListPatches.clear();
+}
+
+void Scene::collectActiveRange(uint32_t first, uint32_t end, std::vector<GameObject*>& active,
+    std::vector<GameObject*>& rendered, std::vector<GameObject*>& submitted) const {
+    // An inactive object cuts out its whole subtree range without visiting it
+    for (uint32_t i = first; i < end;) {
+        GameObject* object = hierarchy.getObject(i);
+        if (!object->isActiveSelf()) {
+            i = hierarchy.getSubtreeEnd(i);
+            continue;
+        }
+
+        active.push_back(object);
+        if (object->hasRenderHooks()) rendered.push_back(object);
+        if (object->hasSubmitHooks()) submitted.push_back(object);
+        ++i;
+    }
+}
+
+void Scene::patchActiveLists(const ListPatch& patch) {
+    // The hierarchy is current here (a rebuild forces a full pass), so a dead or foreign handle
+    // has nothing left to patch
+    uint32_t first = hierarchy.findIndex(patch.object);
+    if (first == SceneHierarchy::None) return;
+    uint32_t end = patch.subtree ? hierarchy.getSubtreeEnd(first) : first + 1;
+
+    // Fresh entries for the range (none if an ancestor is inactive)
+    patchActive.clear();
+    patchRender.clear();
+    patchSubmit.clear();
+    GameObject* parent = hierarchy.getObject(first)->getParent();
+    if (!parent || parent->isActiveInHierarchy()) {
+        if (patch.subtree) {
+            collectActiveRange(first, end, patchActive, patchRender, patchSubmit);
+        }
+        else if (GameObject* object = hierarchy.getObject(first); object->isActiveSelf()) {
+            patchActive.push_back(object);
+            if (object->hasRenderHooks()) patchRender.push_back(object);
+            if (object->hasSubmitHooks()) patchSubmit.push_back(object);
+        }
+    }
+
+    replaceRange(activeObjects, first, end, patchActive);
+    replaceRange(renderObjects, first, end, patchRender);
+    replaceRange(submitObjects, first, end, patchSubmit);
+}
+
+void Scene::replaceRange(std::vector<GameObject*>& list, uint32_t first, uint32_t end,
+    const std::vector<GameObject*>& entries) const {
+    // The lists are in depth-first order: the range is a contiguous run found by binary search
+    auto before = [this](GameObject* object, uint32_t index) {
+        return hierarchy.findIndex(object->getHandle()) < index;
+    };
+    auto lo = std::lower_bound(list.begin(), list.end(), first, before);
+    auto hi = std::lower_bound(lo, list.end(), end, before);
+
+    size_t position = static_cast<size_t>(lo - list.begin());
+    list.erase(lo, hi);
+    list.insert(list.begin() + position, entries.begin(), entries.end());
+}
+
+uint32_t Scene::findDenseIndex(EntityHandle handle) const {
+    if (handle.isNull() || handle.index >= slots.size()) return InvalidIndex;
+
+    // A slot index can be reused by an object outside the scene - compare generations too
+    uint32_t index = slots[handle.index].dense;
+    if (index == InvalidIndex || dense[index]->getHandle() != handle) return InvalidIndex;
+    return index;
+}
+
+void Scene::registerSubtree(GameObject* object) {
+    uint32_t slot = object->getHandle().index;
+    if (slot >= slots.size()) {
+        slots.resize(slot + 1);
+    }
+    slots[slot].dense = static_cast<uint32_t>(dense.size());
+    dense.push_back(object);
+    hierarchyDirty = true;
+
+    object->setListener(this);
+    for (const auto& query : queries) {
+        if (query->matches(*object)) query->insert(object);
+    }
+
+    for (const auto& child : object->getChildren()) {
+        registerSubtree(child.get());
+    }
+}
+
+void Scene::unregisterSubtree(GameObject* object) {
+    for (const auto& child : object->getChildren()) {
+        unregisterSubtree(child.get());
+    }
+
+    for (Component* component : object->getAllComponents()) {
+        component->onDestroy();
+    }
+
+    object->setListener(nullptr);
+    for (const auto& query : queries) {
+        if (query->contains(*object)) query->erase(*object);
+    }
+
+    // Swap-and-pop: the last object takes the freed place
+    uint32_t slot = object->getHandle().index;
+    uint32_t index = slots[slot].dense;
+    uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+    if (index != last) {
+        dense[index] = dense[last];
+        slots[dense[index]->getHandle().index].dense = index;
+    }
+    dense.pop_back();
+    slots[slot].dense = InvalidIndex;
+    hierarchyDirty = true;
+}
+
+// ==================== Queries ====================
+EntityHandle Scene::findByName(const std::string& name) {
+    // Depth-first order: the same object GameObject::findByName would return
+    for (GameObject* object : getHierarchy().getObjects()) {
+        if (object->getName() == name) return object->getHandle();
+    }
+    return EntityHandle();
+}
+
+EntityHandle Scene::findWithComponent(const std::string& componentType) {
+    rebuildComponentCache();
+
+    auto it = componentCache.find(componentType);
+    if (it == componentCache.end() || it->second.empty()) return EntityHandle();
+    return it->second.front();
+}
+
+std::vector<EntityHandle> Scene::getAllWithComponent(const std::string& componentType) {
+    rebuildComponentCache();
+
+    auto it = componentCache.find(componentType);
+    if (it == componentCache.end()) return {};
+    return it->second;
+}
+
+void Scene::rebuildComponentCache() {
+    // Rebuilt only after objects or components of this scene were added or removed
+    if (componentCacheValid) return;
+
+    for (auto& entry : componentCache) {
+        entry.second.clear();
+    }
+    for (GameObject* object : dense) {
+        for (Component* component : object->getAllComponents()) {
+            std::vector<EntityHandle>& list = componentCache[component->getTypeName()];
+            // Several components of one type on the object - the object is listed once
+            if (list.empty() || list.back() != object->getHandle()) {
+                list.push_back(object->getHandle());
+            }
+        }
+    }
+
+    componentCacheValid = true;
+}
+
+SceneQuery& Scene::getQuery(ComponentMask required, LayerMask layers) {
+    // Few distinct queries per scene - a linear search is cheaper than hashing
+    for (const auto& query : queries) {
+        if (query->getRequiredMask() == required && query->getLayerMask() == layers) {
+            return *query;
+        }
+    }
+
+    queries.push_back(std::make_unique<SceneQuery>(required, layers));
+    SceneQuery& query = *queries.back();
+    for (GameObject* object : dense) {
+        if (query.matches(*object)) query.insert(object);
+    }
+    return query;
+}
+
+void Scene::onStructureChanged(GameObject& object) {
+    componentCacheValid = false;
+    // Only the object's own render / submit membership can change
+    pendingListPatches.push_back({ object.getHandle(), false });
+
+    for (const auto& query : queries) {
+        bool matches = query->matches(object);
+        if (matches != query->contains(object)) {
+            if (matches) query->insert(&object);
+            else query->erase(object);
+        }
+    }
+}
+
+void Scene::onActivityChanged(GameObject& object) {
+    pendingListPatches.push_back({ object.getHandle(), true });
+}
+
+// ==================== Frame ====================
+void Scene::start() {
+    for (GameObject* object : getActiveObjects()) {
+        object->startComponents();
+    }
+}
+
+void Scene::update(float deltaTime, ComponentMask systemTicked) {
+    PROFILE_SCOPE("Scene::update");
+
+    // The lists are not rebuilt during the walk: objects created or activated by components
+    // join the walk on the next step, destruction and reparenting are deferred
+    refreshActiveLists();
+    size_t count = activeObjects.size();
+
+    updating = true;
+    {
+        // Archetype rows must not move while components run (GameObject::emplaceArchetypeComponent)
+        ArchetypeStorage::StructuralLock lock;
+        for (size_t i = 0; i < count; ++i) {
+            GameObject* object = activeObjects[i];
+
+            if (object->advanceTick(stepIndex, relevanceOrigin, deltaTime)) {
+                object->updateComponents(object->getTickDelta(), systemTicked);
+            }
+        }
+    }
+    updating = false;
+    ++stepIndex;
+    attachPendingObjects();
+
+    // Sync point: structural changes recorded by components are applied in one batch
+    CommandBuffer::playbackAll();
+}
+
+void Scene::advanceTicks(float deltaTime) {
+    refreshActiveLists();
+    for (GameObject* object : activeObjects) {
+        object->advanceTick(stepIndex, relevanceOrigin, deltaTime);
+    }
+    ++stepIndex;
+}
+
+void Scene::render() {
+    PROFILE_SCOPE("Scene::render");
+
+    refreshActiveLists();
+    for (GameObject* object : renderObjects) {
+        object->renderComponents();
+    }
+}
+
+void Scene::submit(FrameSnapshot& frame) {
+    refreshActiveLists();
+    for (GameObject* object : submitObjects) {
+        object->submitComponents(frame);
+    }
+}
+
+// ==================== Cameras ====================
+Camera* Scene::createCamera(const std::string& name) {
+    cameras.push_back(std::make_unique<Camera>());
+    Camera* camera = cameras.back().get();
+    LOG_DEBUG("Scene '%s': camera '%s' created", this->name.c_str(), name.c_str());
+
+    if (!activeCamera) {
+        activeCamera = camera;
+    }
+    return camera;
+}
+
+void Scene::setActiveCamera(Camera* camera) {
+    activeCamera = camera;
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "GameObject.h"
+#include "SceneQuery.h"
+#include "SceneHierarchy.h"
 #include "Camera.h"
 #include <vector>
 #include <memory>
@@ -7,24 +9,93 @@
 #include <string>
 #include <functional>
 
-class Scene
+// Scene owns its root objects; children stay owned by their parents.
+// Every object of the scene (roots and descendants) is also kept in a dense array, so
+// update/render walk it linearly. Handles are the stable IDs: EntityRegistry recycles
+// slots through its free list and bumps generations, the scene maps slot index -> dense
+// index and removes objects with swap-and-pop. Hierarchy changes must go through the
+// scene (createGameObject with a parent, destroyGameObject), otherwise the dense array
+// does not see the new objects.
+// Update, render and other full-tree passes walk the flattened depth-first hierarchy
+// (parents before children), rebuilt lazily after structural changes. Per-frame passes use
+// lists of active objects only: inactive subtrees are cut out when the lists are rebuilt
+// (after activity, hierarchy or component changes), so hot loops carry no dead entries.
+// Typed queries (query<T...>) are cached and maintained incrementally: the scene listens to
+// component and layer changes of its objects.
+class Scene : private GameObjectListener
 {
 public:
     Scene(const std::string& name);
     ~Scene();
 
-    // Object management
-    GameObject* createGameObject(const std::string& name = "GameObject");
-    GameObject* createGameObject(const std::string& name, GameObject* parent);
-    void destroyGameObject(GameObject* obj);
-    GameObject* findByName(const std::string& name);
-    GameObject* findWithComponent(const std::string& componentType);
-    std::vector<GameObject*> getAllWithComponent(const std::string& componentType);
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    // Object management (objects are referenced by handles, resolve() gives the current address).
+    // Structural changes are deferred while the scene is being walked, so the dense array and the
+    // hierarchy are not reordered under the walk:
+    // - inside update() a created object is built detached (its handle resolves at once) and joins
+    //   the scene right after the component loop;
+    // - inside the system phase (systems may run on worker threads, where the registry must not
+    //   change) creation is recorded into the thread's CommandBuffer and the returned handle is
+    //   null - use CommandBuffer::createGameObject with init to configure the object;
+    // - destroyGameObject and setParent are recorded into the thread's CommandBuffer in both phases
+    //   and played back at the sync point (CommandBuffer::playbackAll)
+    EntityHandle createGameObject(const std::string& name = "GameObject");
+    EntityHandle createGameObject(const std::string& name, EntityHandle parent);
+    // Destroys the object with its whole subtree (deferred while walking, see above)
+    void destroyGameObject(EntityHandle handle);
+    EntityHandle findByName(const std::string& name);
+    EntityHandle findWithComponent(const std::string& componentType);
+    std::vector<EntityHandle> getAllWithComponent(const std::string& componentType);
+
+    // Cached query for objects with all of T... (registered component types) in the given layers.
+    // The first call for a combination fills the set, later calls return the same object.
+    // A type without a mask bit (beyond MaxComponentTypes) makes the query match nothing
+    template<typename... T>
+    SceneQuery& query(LayerMask layers = AllLayers) {
+        static_assert(sizeof...(T) > 0, "Query needs at least one component type");
+        static_assert((isRegisteredComponent<T> && ...), "Queries only support types with REGISTER_COMPONENT");
+        return getQuery((getComponentBit<T>() | ...), layers);
+    }
+    SceneQuery& getQuery(ComponentMask required, LayerMask layers = AllLayers);
+
+    GameObject* resolve(EntityHandle handle) const { return EntityRegistry::getInstance().resolve(handle); }
+    bool contains(EntityHandle handle) const { return findDenseIndex(handle) != InvalidIndex; }
 
     // Scene graph
     void addGameObject(std::unique_ptr<GameObject> obj);
-    void update(float deltaTime);
+    // Adds the object as a child of parent (a root if the parent is not in the scene)
+    void addGameObject(std::unique_ptr<GameObject> obj, EntityHandle parent);
+    // Reserves room for count more objects (bulk spawning, see Prefab::instantiate)
+    void reserve(size_t count);
+    // Moves the object (with its subtree) under newParent; a null parent makes it a root.
+    // While walking the move is recorded (true means recorded) and checked again on playback
+    bool setParent(EntityHandle child, EntityHandle newParent);
+    // Sets the object's own active flag; descendants follow through activeInHierarchy
+    void setActive(EntityHandle handle, bool active);
+    // Flattened hierarchy, rebuilt here if objects were added, removed or reparented
+    const SceneHierarchy& getHierarchy();
+    // Active-in-hierarchy objects in depth-first order
+    const std::vector<GameObject*>& getActiveObjects();
+
+    void start();
+    // Objects tick according to their TickPolicy (GameObject::advanceTick).
+    // systemTicked: component types updated by systems this step (their virtual update is skipped)
+    void update(float deltaTime, ComponentMask systemTicked = 0);
+    // Only the tick decisions of update (for a step that runs systems without component updates)
+    void advanceTicks(float deltaTime);
+    // Called by SystemScheduler around its systems: structural changes are recorded, not applied
+    void beginSystemPhase() { runningSystems = true; }
+    void endSystemPhase() { runningSystems = false; }
     void render();
+    void submit(FrameSnapshot& frame);
+
+    // Point of interest for TickMode::Distance (usually the camera position)
+    void setRelevanceOrigin(const glm::vec3& origin) { relevanceOrigin = origin; }
+    const glm::vec3& getRelevanceOrigin() const { return relevanceOrigin; }
+    // Number of simulation steps run by update()
+    uint64_t getStepIndex() const { return stepIndex; }
 
     // Camera management
     Camera* createCamera(const std::string& name = "Camera");
@@ -33,7 +104,11 @@ public:
 
     // Getters
     const std::string& getName() const { return name; }
+    // Root objects (owned by the scene)
     const std::vector<std::unique_ptr<GameObject>>& getObjects() const { return objects; }
+    // All objects of the scene, unordered (swap-and-pop changes the order on destruction)
+    const std::vector<GameObject*>& getAllObjects() const { return dense; }
+    size_t getObjectCount() const { return dense.size(); }
     const std::vector<std::unique_ptr<Camera>>& getCameras() const { return cameras; }
 
     // Events
@@ -42,11 +117,69 @@ public:
     SceneEvent onUnload;
 
 private:
+    static constexpr uint32_t InvalidIndex = ~0u;
+
+    // Position of a registry slot in the scene
+    struct Slot {
+        uint32_t dense = InvalidIndex;  // Index in dense
+        uint32_t root = InvalidIndex;   // Index in objects (only for roots)
+    };
+
     std::string name;
     std::vector<std::unique_ptr<GameObject>> objects;
+    std::vector<GameObject*> dense;
+    std::vector<Slot> slots;            // Indexed by EntityHandle::index
+    bool updating = false;
+    bool runningSystems = false;
+
+    // Objects created during update(), attached after the component loop in creation order
+    struct PendingObject {
+        std::unique_ptr<GameObject> object;
+        EntityHandle parent;
+    };
+    std::vector<PendingObject> pendingObjects;
     std::vector<std::unique_ptr<Camera>> cameras;
     Camera* activeCamera = nullptr;
-    std::unordered_map<std::string, std::vector<GameObject*>> componentCache;
+    std::unordered_map<std::string, std::vector<EntityHandle>> componentCache;
+    bool componentCacheValid = false;
+    std::vector<std::unique_ptr<SceneQuery>> queries;
+    SceneHierarchy hierarchy;
+    bool hierarchyDirty = true;
+    glm::vec3 relevanceOrigin = glm::vec3(0.0f);
+
+    // Tick and render lists (active objects only), in depth-first order. Changes of this scene's
+    // objects arrive through the listener: setActive patches only the toggled subtree range,
+    // a component change only the object itself. A hierarchy rebuild (or a large batch of
+    // patches) rebuilds the lists with one full pass
+    struct ListPatch {
+        EntityHandle object;
+        bool subtree;       // Whole subtree range (activity) or the object alone (components)
+    };
+    static constexpr size_t MinPatchRebuild = 64;
+
+    std::vector<GameObject*> activeObjects;
+    std::vector<GameObject*> renderObjects;     // Active objects with render hooks
+    std::vector<GameObject*> submitObjects;     // Active objects with submit hooks
+    bool activeListsDirty = true;
+    std::vector<ListPatch> pendingListPatches;  // Applied by refreshActiveLists (not during update)
+    std::vector<GameObject*> patchActive;       // Patch scratch (kept to reuse memory)
+    std::vector<GameObject*> patchRender;
+    std::vector<GameObject*> patchSubmit;
+    uint64_t stepIndex = 0;
 
+    bool isRecording() const { return updating || runningSystems; }
+    void attachPendingObjects();
+    uint32_t findDenseIndex(EntityHandle handle) const;
+    void registerSubtree(GameObject* object);
+    void unregisterSubtree(GameObject* object);
+    void destroyImmediate(EntityHandle handle);
     void rebuildComponentCache();
-};
\ No newline at end of file
+    void refreshActiveLists();
+    void collectActiveRange(uint32_t first, uint32_t end, std::vector<GameObject*>& active,
+        std::vector<GameObject*>& rendered, std::vector<GameObject*>& submitted) const;
+    void patchActiveLists(const ListPatch& patch);
+    void replaceRange(std::vector<GameObject*>& list, uint32_t first, uint32_t end,
+        const std::vector<GameObject*>& entries) const;
+    void onStructureChanged(GameObject& object) override;
+    void onActivityChanged(GameObject& object) override;
+};
@@ -0,0 +1,80 @@
+#include "SceneHierarchy.h"
+#include "Profiler.h"
+#include <algorithm>
+
+void SceneHierarchy::rebuild(const std::vector<std::unique_ptr<GameObject>>& rootObjects) {
+    PROFILE_SCOPE("SceneHierarchy::rebuild");
+
+    objects.clear();
+    parents.clear();
+    firstChildren.clear();
+    nextSiblings.clear();
+    roots.clear();
+    lastChildren.clear();
+    stack.clear();
+
+    // Children are pushed in reverse so they come out in their original order
+    for (auto it = rootObjects.rbegin(); it != rootObjects.rend(); ++it) {
+        stack.push_back({ it->get(), None });
+    }
+
+    while (!stack.empty()) {
+        StackEntry entry = stack.back();
+        stack.pop_back();
+
+        uint32_t index = static_cast<uint32_t>(objects.size());
+        objects.push_back(entry.object);
+        parents.push_back(entry.parent);
+        firstChildren.push_back(None);
+        nextSiblings.push_back(None);
+        lastChildren.push_back(None);
+
+        if (entry.parent == None) {
+            roots.push_back(index);
+        }
+        else if (firstChildren[entry.parent] == None) {
+            firstChildren[entry.parent] = index;
+        }
+        else {
+            nextSiblings[lastChildren[entry.parent]] = index;
+        }
+        if (entry.parent != None) {
+            lastChildren[entry.parent] = index;
+        }
+
+        const auto& children = entry.object->getChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.push_back({ it->get(), index });
+        }
+    }
+
+    // Children follow their parent, so one backward pass extends every range to its last descendant
+    size_t count = objects.size();
+    subtreeEnds.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        subtreeEnds[i] = static_cast<uint32_t>(i + 1);
+    }
+    for (size_t i = count; i-- > 0;) {
+        uint32_t parent = parents[i];
+        if (parent != None) {
+            subtreeEnds[parent] = std::max(subtreeEnds[parent], subtreeEnds[i]);
+        }
+    }
+
+    std::fill(indexBySlot.begin(), indexBySlot.end(), None);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t slot = objects[i]->getHandle().index;
+        if (slot >= indexBySlot.size()) {
+            indexBySlot.resize(slot + 1, None);
+        }
+        indexBySlot[slot] = static_cast<uint32_t>(i);
+    }
+}
+
+uint32_t SceneHierarchy::findIndex(EntityHandle handle) const {
+    if (handle.isNull() || handle.index >= indexBySlot.size()) return None;
+
+    uint32_t index = indexBySlot[handle.index];
+    if (index == None || objects[index]->getHandle() != handle) return None;
+    return index;
+}
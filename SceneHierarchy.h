@@ -0,0 +1,50 @@
+#pragma once
+#include "GameObject.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Flattened scene hierarchy: objects in depth-first order with parent / first-child /
+// next-sibling indices. A subtree is the contiguous range [index, getSubtreeEnd(index)),
+// and every parent precedes its children, so full-tree passes are linear scans.
+// Scene rebuilds it lazily after objects are created, destroyed or reparented.
+class SceneHierarchy {
+public:
+    static constexpr uint32_t None = ~0u;
+
+    // Depth-first walk of the roots (explicit stack - no recursion for deep trees)
+    void rebuild(const std::vector<std::unique_ptr<GameObject>>& roots);
+
+    size_t size() const { return objects.size(); }
+    bool empty() const { return objects.empty(); }
+
+    const std::vector<GameObject*>& getObjects() const { return objects; }
+    GameObject* getObject(uint32_t index) const { return objects[index]; }
+    uint32_t getParent(uint32_t index) const { return parents[index]; }
+    uint32_t getFirstChild(uint32_t index) const { return firstChildren[index]; }
+    uint32_t getNextSibling(uint32_t index) const { return nextSiblings[index]; }
+    uint32_t getSubtreeEnd(uint32_t index) const { return subtreeEnds[index]; }
+    const std::vector<uint32_t>& getParents() const { return parents; }
+    // Indices of root objects (each root starts its subtree range)
+    const std::vector<uint32_t>& getRoots() const { return roots; }
+
+    // Index of the object in depth-first order (None if not in the hierarchy)
+    uint32_t findIndex(EntityHandle handle) const;
+
+private:
+    std::vector<GameObject*> objects;
+    std::vector<uint32_t> parents;
+    std::vector<uint32_t> firstChildren;
+    std::vector<uint32_t> nextSiblings;
+    std::vector<uint32_t> subtreeEnds;
+    std::vector<uint32_t> roots;
+    std::vector<uint32_t> indexBySlot;      // Indexed by EntityHandle::index
+
+    // Rebuild scratch (kept to reuse memory)
+    struct StackEntry {
+        GameObject* object;
+        uint32_t parent;
+    };
+    std::vector<StackEntry> stack;
+    std::vector<uint32_t> lastChildren;
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include "GameObject.h"
+#include <vector>
+
+// Cached query result: all scene objects that have every component of the required mask
+// and whose layer is in the layer mask. Scene keeps the set up to date as objects are
+// created/destroyed and components are added/removed, so reading it each frame is a plain
+// array walk without allocations or hashing. Inactive objects are included.
+// Obtained through Scene::query and valid for the lifetime of the scene.
+class SceneQuery {
+public:
+    SceneQuery(ComponentMask required, LayerMask layers) : required(required), layers(layers) {}
+
+    SceneQuery(const SceneQuery&) = delete;
+    SceneQuery& operator=(const SceneQuery&) = delete;
+
+    bool matches(const GameObject& object) const {
+        return (object.getComponentMask() & required) == required && (object.getLayerBit() & layers) != 0;
+    }
+
+    ComponentMask getRequiredMask() const { return required; }
+    LayerMask getLayerMask() const { return layers; }
+
+    // Matching objects (unordered: removal is swap-and-pop)
+    size_t size() const { return objects.size(); }
+    bool empty() const { return objects.empty(); }
+    GameObject* operator[](size_t index) const { return objects[index]; }
+    auto begin() const { return objects.begin(); }
+    auto end() const { return objects.end(); }
+
+    // func(GameObject&, T&...) for every active matching object; T... must be part of the query
+    template<typename... T, typename Func>
+    void forEach(Func&& func) const {
+        for (GameObject* object : objects) {
+            if (!object->isActive()) continue;
+            func(*object, *object->getComponent<T>()...);
+        }
+    }
+
+private:
+    friend class Scene;
+
+    static constexpr uint32_t InvalidPosition = ~0u;
+
+    bool contains(const GameObject& object) const {
+        uint32_t slot = object.getHandle().index;
+        return slot < positions.size() && positions[slot] != InvalidPosition;
+    }
+
+    void insert(GameObject* object) {
+        uint32_t slot = object->getHandle().index;
+        if (slot >= positions.size()) {
+            positions.resize(slot + 1, InvalidPosition);
+        }
+        positions[slot] = static_cast<uint32_t>(objects.size());
+        objects.push_back(object);
+    }
+
+    void erase(const GameObject& object) {
+        uint32_t slot = object.getHandle().index;
+        uint32_t index = positions[slot];
+        uint32_t last = static_cast<uint32_t>(objects.size() - 1);
+        if (index != last) {
+            objects[index] = objects[last];
+            positions[objects[index]->getHandle().index] = index;
+        }
+        objects.pop_back();
+        positions[slot] = InvalidPosition;
+    }
+
+    ComponentMask required;
+    LayerMask layers;
+    std::vector<GameObject*> objects;
+    std::vector<uint32_t> positions;    // Index in objects by EntityHandle::index
+};
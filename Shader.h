@@ -1,6 +1,7 @@
 #pragma once
 #include <glad/glad.h>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -134,6 +135,14 @@ private:
     }
 };
 
+// Хэш для поиска в кэше по std::string_view без создания временной std::string
+struct UniformNameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view name) const {
+        return std::hash<std::string_view>{}(name);
+    }
+};
+
 // Класс для шейдерной программы (линковка нескольких шейдеров)
 class ShaderProgram {
 private:
@@ -142,7 +151,7 @@ private:
     bool inUse = false;
 
     // Кэш для location uniform-переменных
-    std::unordered_map<std::string, GLint> uniformLocations;
+    std::unordered_map<std::string, GLint, UniformNameHash, std::equal_to<>> uniformLocations;
 
 public:
     // Конструкторы
@@ -296,19 +305,34 @@ public:
 
     // ==================== Установка uniform-переменных ====================
 
-    // Получение location uniform-переменной (с кэшированием)
-    GLint getUniformLocation(const std::string& name) {
+    // Есть ли в программе uniform-переменная (без предупреждения, результат кэшируется)
+    bool hasUniform(std::string_view name) {
+        auto it = uniformLocations.find(name);
+        if (it != uniformLocations.end()) {
+            return it->second != -1;
+        }
+
+        std::string key(name);
+        GLint location = glGetUniformLocation(programID, key.c_str());
+        uniformLocations.emplace(std::move(key), location);
+        return location != -1;
+    }
+
+    // Получение location uniform-переменной (с кэшированием).
+    // Имя принимается как std::string_view: поиск в кэше не выделяет память
+    GLint getUniformLocation(std::string_view name) {
         // Проверяем кэш
         auto it = uniformLocations.find(name);
         if (it != uniformLocations.end()) {
             return it->second;
         }
 
-        // Получаем location
-        GLint location = glGetUniformLocation(programID, name.c_str());
+        // Получаем location (строка с нулем на конце нужна только при первом обращении)
+        std::string key(name);
+        GLint location = glGetUniformLocation(programID, key.c_str());
 
         // Кэшируем результат (даже если -1)
-        uniformLocations[name] = location;
+        uniformLocations.emplace(std::move(key), location);
 
         if (location == -1 && linked) {
             std::cerr << "Warning: Uniform '" << name
@@ -319,12 +343,12 @@ public:
     }
 
     // Установка bool
-    void setBool(const std::string& name, bool value) {
+    void setBool(std::string_view name, bool value) {
         setInt(name, value ? 1 : 0);
     }
 
     // Установка int
-    void setInt(const std::string& name, int value) {
+    void setInt(std::string_view name, int value) {
         if (!inUse) use();
         GLint location = getUniformLocation(name);
         if (location != -1) {
@@ -333,7 +357,7 @@ public:
     }
 
     // Установка float
-    void setFloat(const std::string& name, float value) {
+    void setFloat(std::string_view name, float value) {
         if (!inUse) use();
         GLint location = getUniformLocation(name);
         if (location != -1) {
@@ -342,7 +366,7 @@ public:
     }
 
     // Установка vec2
-    void setVec2(const std::string& name, const glm::vec2& value) {
+    void setVec2(std::string_view name, const glm::vec2& value) {
         if (!inUse) use();
         GLint location = getUniformLocation(name);
         if (location != -1) {
@@ -350,12 +374,12 @@ public:
         }
     }
 
-    void setVec2(const std::string& name, float x, float y) {
+    void setVec2(std::string_view name, float x, float y) {
         setVec2(name, glm::vec2(x, y));
     }
 
     // Установка vec3
-    void setVec3(const std::string& name, const glm::vec3& value) {
+    void setVec3(std::string_view name, const glm::vec3& value) {
         if (!inUse) use();
         GLint location = getUniformLocation(name);
         if (location != -1) {
@@ -363,12 +387,12 @@ public:
         }
     }
 
-    void setVec3(const std::string& name, float x, float y, float z) {
+    void setVec3(std::string_view name, float x, float y, float z) {
         setVec3(name, glm::vec3(x, y, z));
     }
 
     // Установка vec4
-    void setVec4(const std::string& name, const glm::vec4& value) {
+    void setVec4(std::string_view name, const glm::vec4& value) {
         if (!inUse) use();
         GLint location = getUniformLocation(name);
         if (location != -1) {
@@ -376,12 +400,12 @@ public:
         }
     }
 
-    void setVec4(const std::string& name, float x, float y, float z, float w) {
+    void setVec4(std::string_view name, float x, float y, float z, float w) {
         setVec4(name, glm::vec4(x, y, z, w));
     }
 
     // Установка mat2
-    void setMat2(const std::string& name, const glm::mat2& mat) {
+    void setMat2(std::string_view name, const glm::mat2& mat) {
         if (!inUse) use();
         GLint location = getUniformLocation(name);
         if (location != -1) {
@@ -390,7 +414,7 @@ public:
     }
 
     // Установка mat3
-    void setMat3(const std::string& name, const glm::mat3& mat) {
+    void setMat3(std::string_view name, const glm::mat3& mat) {
         if (!inUse) use();
         GLint location = getUniformLocation(name);
         if (location != -1) {
@@ -399,7 +423,7 @@ public:
     }
 
     // Установка mat4
-    void setMat4(const std::string& name, const glm::mat4& mat) {
+    void setMat4(std::string_view name, const glm::mat4& mat) {
         if (!inUse) use();
         GLint location = getUniformLocation(name);
         if (location != -1) {
@@ -0,0 +1,78 @@
+#include "SlabPool.h"
+
+// ==================== Конструктор ====================
+SlabPool::SlabPool(size_t blockSize, size_t blockAlignment, size_t blocksPerSlab)
+    : blockAlignment(blockAlignment < alignof(FreeBlock) ? alignof(FreeBlock) : blockAlignment),
+    blocksPerSlab(blocksPerSlab > 0 ? blocksPerSlab : 1) {
+    // В свободном блоке хранится ссылка на следующий, соседние блоки выровнены
+    size_t size = blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize;
+    this->blockSize = (size + this->blockAlignment - 1) / this->blockAlignment * this->blockAlignment;
+}
+
+SlabPool::~SlabPool() {
+    for (const Slab& slab : slabs) {
+        ::operator delete(slab.memory, std::align_val_t(blockAlignment));
+    }
+}
+
+// ==================== Выделение ====================
+void* SlabPool::allocate() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!freeList) {
+        addSlab(blocksPerSlab);
+    }
+
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    --freeCount;
+    return block;
+}
+
+void SlabPool::deallocate(void* block) {
+    if (!block) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = freeList;
+    freeList = freeBlock;
+    ++freeCount;
+}
+
+void SlabPool::reserve(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (freeCount < count) {
+        addSlab(count - freeCount);
+    }
+}
+
+void SlabPool::addSlab(size_t blocks) {
+    std::byte* memory = static_cast<std::byte*>(
+        ::operator new(blocks * blockSize, std::align_val_t(blockAlignment)));
+    slabs.push_back({ memory, blocks });
+
+    // Блоки нового слаба идут в список по возрастанию адресов
+    for (size_t i = blocks; i > 0; --i) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(memory + (i - 1) * blockSize);
+        block->next = freeList;
+        freeList = block;
+    }
+    freeCount += blocks;
+    capacity += blocks;
+}
+
+// ==================== Геттеры ====================
+size_t SlabPool::getAllocatedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity - freeCount;
+}
+
+size_t SlabPool::getCapacity() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+}
+
+size_t SlabPool::getSlabCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slabs.size();
+}
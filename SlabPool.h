@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// ==================== Пул блоков фиксированного размера ====================
+// Память выделяется крупными слабами (slab) по blocksPerSlab блоков; освобожденные блоки
+// возвращаются в список свободных и переиспользуются, а слабы живут до уничтожения пула.
+// Выделение и освобождение - снятие/добавление узла списка под мьютексом
+class SlabPool {
+public:
+    static constexpr size_t DefaultBlocksPerSlab = 256;
+
+    SlabPool(size_t blockSize, size_t blockAlignment, size_t blocksPerSlab = DefaultBlocksPerSlab);
+    ~SlabPool();
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    // ==================== Выделение ====================
+    void* allocate();
+    void deallocate(void* block);
+
+    // Заранее выделить память так, чтобы свободных блоков было не меньше count
+    void reserve(size_t count);
+
+    // ==================== Геттеры ====================
+    size_t getBlockSize() const { return blockSize; }
+    size_t getAllocatedCount() const;
+    size_t getCapacity() const;
+    size_t getSlabCount() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Slab {
+        std::byte* memory;
+        size_t blocks;
+    };
+
+    void addSlab(size_t blocks);
+
+    size_t blockSize;
+    size_t blockAlignment;
+    size_t blocksPerSlab;
+
+    mutable std::mutex mutex;
+    FreeBlock* freeList = nullptr;
+    size_t freeCount = 0;
+    size_t capacity = 0;
+    std::vector<Slab> slabs;
+};
+
+// ==================== Пул объектов типа ====================
+// Общий пул для всех объектов T. Запросы другого размера (наследник T без собственного пула)
+// обслуживает обычный operator new
+template<typename T>
+class ObjectPool {
+public:
+    static SlabPool& getPool() {
+        static SlabPool pool(sizeof(T), alignof(T));
+        return pool;
+    }
+
+    static void* allocate(size_t size) {
+        if (size != sizeof(T)) return ::operator new(size);
+        return getPool().allocate();
+    }
+
+    static void deallocate(void* object, size_t size) noexcept {
+        if (!object) return;
+        if (size != sizeof(T)) {
+            ::operator delete(object);
+            return;
+        }
+        getPool().deallocate(object);
+    }
+
+    static void reserve(size_t count) { getPool().reserve(count); }
+};
+
+// Операторы new/delete класса, направляющие его выделения в ObjectPool<TYPE>.
+// Размещающий new объявлен явно: операторы класса скрывают глобальные
+#define DECLARE_POOLED_ALLOCATION(TYPE) \
+    static void* operator new(size_t size) { return ObjectPool<TYPE>::allocate(size); } \
+    static void operator delete(void* object, size_t size) noexcept { ObjectPool<TYPE>::deallocate(object, size); } \
+    static void* operator new(size_t, void* where) noexcept { return where; } \
+    static void operator delete(void*, void*) noexcept {}
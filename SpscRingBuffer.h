@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// ==================== Кольцевой буфер SPSC ====================
+// Очередь фиксированного размера без блокировок для одного писателя и одного читателя.
+// Память выделена заранее - добавление и извлечение не выделяют память
+template<typename T, size_t Capacity>
+class SpscRingBuffer {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Емкость должна быть степенью двойки");
+
+public:
+    // ==================== Сторона писателя ====================
+
+    // false - буфер заполнен, элемент не добавлен
+    bool tryPush(const T& value) {
+        size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - readIndex.load(std::memory_order_acquire) == Capacity) return false;
+
+        buffer[head & (Capacity - 1)] = value;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ==================== Сторона читателя ====================
+
+    bool tryPop(T& value) {
+        return popBatch(&value, 1) == 1;
+    }
+
+    // Извлечь до maxCount элементов за одну синхронизацию. Возвращает количество извлеченных
+    size_t popBatch(T* out, size_t maxCount) {
+        size_t tail = readIndex.load(std::memory_order_relaxed);
+        size_t available = writeIndex.load(std::memory_order_acquire) - tail;
+        size_t count = available < maxCount ? available : maxCount;
+
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = buffer[(tail + i) & (Capacity - 1)];
+        }
+        readIndex.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // ==================== Геттеры ====================
+    static constexpr size_t capacity() { return Capacity; }
+    bool empty() const {
+        return writeIndex.load(std::memory_order_acquire) == readIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    // Индексы на разных кэш-линиях, чтобы писатель и читатель не мешали друг другу
+    alignas(64) std::atomic<size_t> writeIndex{ 0 };
+    alignas(64) std::atomic<size_t> readIndex{ 0 };
+    T buffer[Capacity];
+};
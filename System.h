@@ -0,0 +1,169 @@
+#pragma once
+#include "GameObject.h"
+#include "JobSystem.h"
+#include "ArchetypeStorage.h"
+#include <cstddef>
+#include <vector>
+
+// ==================== Контекст выполнения системы ====================
+// Данные шага симуляции и параллельные обходы объектов.
+// Объекты шага - те, что обновляются на нем по своей TickPolicy (GameObject::isTicking):
+// реже обновляемые объекты получают накопленное время GameObject::getTickDelta(),
+// getDeltaTime() - длительность самого шага
+class SystemContext {
+public:
+    SystemContext(float deltaTime, JobSystem* jobSystem, const FrameVector<GameObject*>& objects)
+        : deltaTime(deltaTime), jobSystem(jobSystem), objects(objects) {}
+
+    float getDeltaTime() const { return deltaTime; }
+    JobSystem* getJobSystem() const { return jobSystem; }
+
+    // Активные объекты сцены, обновляемые на этом шаге (обход в глубину)
+    const FrameVector<GameObject*>& getObjects() const { return objects; }
+
+    // func(GameObject&, T&...) для каждого активного объекта со всеми компонентами T.
+    // Объекты делятся на части по grainSize и обрабатываются параллельно
+    template<typename... T, typename Func>
+    void forEach(Func&& func, size_t grainSize = DefaultGrainSize) const {
+        ComponentMask required = (getComponentBit<T>() | ...);
+
+        auto body = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                GameObject* object = objects[i];
+                if ((object->getComponentMask() & required) != required) continue;
+                func(*object, *object->getComponent<T>()...);
+            }
+            };
+
+        if (jobSystem) {
+            jobSystem->parallelFor(objects.size(), grainSize, body);
+        }
+        else {
+            body(0, objects.size());
+        }
+    }
+
+    // func(T* components, size_t count) для каждого блока архетипов с компонентами T
+    // (объекты в режиме ComponentStorage::Archetype). Блоки обрабатываются параллельно.
+    // Обход по хранилищу, а не по объектам шага: активность и TickPolicy здесь не учитываются
+    template<typename T, typename Func>
+    void forEachChunk(Func&& func) const {
+        FrameVector<std::pair<T*, size_t>> chunks{ ArenaAllocator<std::pair<T*, size_t>>(FrameArena::getThreadArena()) };
+        ArchetypeStorage::getInstance().forEachChunk<T>([&chunks](T* components, size_t count) {
+            chunks.emplace_back(components, count);
+            });
+
+        auto body = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                func(chunks[i].first, chunks[i].second);
+            }
+            };
+
+        if (jobSystem) {
+            jobSystem->parallelFor(chunks.size(), 1, body);
+        }
+        else {
+            body(0, chunks.size());
+        }
+    }
+
+    static constexpr size_t DefaultGrainSize = 64;
+
+private:
+    float deltaTime;
+    JobSystem* jobSystem;
+    const FrameVector<GameObject*>& objects;
+};
+
+// ==================== Система ====================
+// Обновление компонентов определенных типов. Система объявляет, какие типы она читает
+// и какие изменяет; системы без конфликтов доступа выполняются параллельно
+class System {
+public:
+    // name - строка со статическим временем жизни (используется профилировщиком)
+    explicit System(const char* name) : name(name) {}
+    virtual ~System() = default;
+
+    virtual void update(const SystemContext& context) = 0;
+
+    // ==================== Доступ к компонентам ====================
+    ComponentMask getReadMask() const { return readMask; }
+    ComponentMask getWriteMask() const { return writeMask; }
+    // Типы, update которых выполняет система: пока она включена и зарегистрирована в планировщике,
+    // шаг этого планировщика не вызывает их виртуальный update
+    ComponentMask getTickedMask() const { return tickedMask; }
+
+    // Системы нельзя выполнять одновременно: одна изменяет то, с чем работает другая
+    bool conflictsWith(const System& other) const {
+        return (writeMask & (other.readMask | other.writeMask)) != 0 ||
+            (readMask & other.writeMask) != 0;
+    }
+
+    // ==================== Геттеры и сеттеры ====================
+    const char* getName() const { return name; }
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool enable) { enabled = enable; }
+
+protected:
+    // Объявление доступа (вызывается в конструкторе наследника)
+    template<typename... T>
+    void reads() { readMask |= (getComponentBit<T>() | ...); }
+
+    template<typename... T>
+    void writes() { writeMask |= (getComponentBit<T>() | ...); }
+
+    // Система обновляет компоненты T вместо их виртуального update. Типы без номера
+    // (сверх MaxComponentTypes) не пропускаются - их обновляет обычный update
+    template<typename T>
+    void ticks() {
+        ComponentTypeId id = getComponentTypeId<T>();
+        if (id != InvalidComponentTypeId) tickedMask |= ComponentMask(1) << id;
+    }
+
+private:
+    const char* name;
+    ComponentMask readMask = 0;
+    ComponentMask writeMask = 0;
+    ComponentMask tickedMask = 0;
+    bool enabled = true;
+};
+
+// ==================== Обновление компонентов системой ====================
+// Компоненты T обновляются прямым вызовом T::update - без виртуального вызова на каждый объект.
+// Пока система включена, Scene::update шага ее планировщика пропускает компоненты T
+// (несколько таких систем или отключение одной из них на это не влияют).
+// По умолчанию объекты обходятся последовательно (update компонента может обращаться
+// к другим объектам); parallel = true - для компонентов, изменяющих только себя
+template<typename T>
+class ComponentTickSystem : public System {
+public:
+    explicit ComponentTickSystem(bool parallel = false) : System(typeid(T).name()), parallel(parallel) {
+        static_assert(getComponentHooks<T>() & HookUpdate, "T не переопределяет update");
+        writes<T>();
+        ticks<T>();
+    }
+
+    void update(const SystemContext& context) override {
+        // Тип без номера обновляет виртуальный update (см. ticks)
+        if (getTickedMask() == 0) return;
+
+        // Время с прошлого обновления объекта (TickPolicy), как у виртуального update
+        auto tick = [](GameObject& object) {
+            float deltaTime = object.getTickDelta();
+            object.forEachComponent<T>([deltaTime](T& component) { component.T::update(deltaTime); });
+            };
+
+        if (parallel) {
+            context.forEach<T>([&tick](GameObject& object, T&) { tick(object); });
+            return;
+        }
+
+        ComponentMask bit = getComponentBit<T>();
+        for (GameObject* object : context.getObjects()) {
+            if (object->getComponentMask() & bit) tick(*object);
+        }
+    }
+
+private:
+    bool parallel;
+};
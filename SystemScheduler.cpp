@@ -0,0 +1,229 @@
+#include "SystemScheduler.h"
+#include "Scene.h"
+#include "CommandBuffer.h"
+#include "Profiler.h"
+#include "TransformBatch.h"
+#include <algorithm>
+
+// ==================== Системы ====================
+void SystemScheduler::removeSystem(System* system) {
+    systems.erase(
+        std::remove_if(systems.begin(), systems.end(),
+            [system](const std::unique_ptr<System>& ptr) { return ptr.get() == system; }),
+        systems.end());
+}
+
+// ==================== Шаг симуляции ====================
+void SystemScheduler::update(float deltaTime, Scene& scene) {
+    if (componentUpdate) {
+        // Типы, которые на этом шаге обновят включенные системы
+        ComponentMask systemTicked = 0;
+        for (const auto& system : systems) {
+            if (system->isEnabled()) systemTicked |= system->getTickedMask();
+        }
+
+        PROFILE_SCOPE("ComponentUpdate");
+        scene.update(deltaTime, systemTicked);
+    }
+    else {
+        // Системам все равно нужны решения TickPolicy этого шага
+        scene.advanceTicks(deltaTime);
+    }
+
+    if (!systems.empty()) {
+        FrameVector<GameObject*> objects{ ArenaAllocator<GameObject*>(FrameArena::getThreadArena()) };
+        objects.reserve(scene.getObjectCount());
+        // Системы обрабатывают те же объекты, что и update: по TickPolicy (реже обновляемые
+        // и спящие пропускают шаг). Объекты, созданные или включенные на этом шаге, еще не решали
+        for (GameObject* object : scene.getActiveObjects()) {
+            if (object->isTicking()) objects.push_back(object);
+        }
+        // Структурные изменения из систем записываются и применяются после них
+        scene.beginSystemPhase();
+        runSystems(deltaTime, objects);
+        scene.endSystemPhase();
+        CommandBuffer::playbackAll();
+    }
+    updateTransforms(scene.getHierarchy());
+}
+
+void SystemScheduler::updateTransforms(const SceneHierarchy& hierarchy) {
+    PROFILE_SCOPE("TransformHierarchy");
+
+    FrameArena& arena = FrameArena::getThreadArena();
+    size_t count = hierarchy.size();
+    const std::vector<GameObject*>& objects = hierarchy.getObjects();
+    const std::vector<uint32_t>& parents = hierarchy.getParents();
+
+    Transform** transforms = arena.allocateArray<Transform*>(count);
+    FrameVector<Transform*> dirty{ ArenaAllocator<Transform*>(arena) };
+    for (size_t i = 0; i < count; ++i) {
+        transforms[i] = objects[i]->getTransform();
+        if (transforms[i]->isDirty()) dirty.push_back(transforms[i]);
+    }
+    if (!dirty.empty()) {
+        composeLocalMatrices(dirty, arena);
+    }
+
+    // Родитель всегда раньше детей: его результат уже готов, когда до них доходит проход
+    bool* changed = arena.allocateArray<bool>(count);
+    const std::vector<uint32_t>& roots = hierarchy.getRoots();
+
+    auto body = [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            uint32_t first = roots[r];
+            uint32_t last = hierarchy.getSubtreeEnd(first);
+            for (uint32_t i = first; i < last; ++i) {
+                // Состояние прошлого шага для интерполяции - у всех объектов, даже без update
+                transforms[i]->storePreviousState();
+
+                uint32_t parent = parents[i];
+                if (parent == SceneHierarchy::None) {
+                    changed[i] = transforms[i]->updateWorldMatrix(nullptr, false);
+                }
+                else {
+                    changed[i] = transforms[i]->updateWorldMatrix(transforms[parent], changed[parent]);
+                }
+            }
+        }
+        };
+
+    if (jobSystem) {
+        jobSystem->parallelFor(roots.size(), TransformGrainSize, body);
+    }
+    else {
+        body(0, roots.size());
+    }
+}
+
+void SystemScheduler::composeLocalMatrices(const FrameVector<Transform*>& transforms, FrameArena& arena) {
+    PROFILE_SCOPE("ComposeLocalMatrices");
+    size_t count = transforms.size();
+
+    // Раскладка в SoA для ядра
+    float* data = arena.allocateArray<float>(count * 10);
+    float* components[10];
+    for (size_t i = 0; i < 10; ++i) {
+        components[i] = data + i * count;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const Transform* transform = transforms[i];
+        const glm::vec3& position = transform->getPosition();
+        const glm::quat& rotation = transform->getRotation();
+        const glm::vec3& scale = transform->getScale();
+
+        components[0][i] = position.x;
+        components[1][i] = position.y;
+        components[2][i] = position.z;
+        components[3][i] = rotation.x;
+        components[4][i] = rotation.y;
+        components[5][i] = rotation.z;
+        components[6][i] = rotation.w;
+        components[7][i] = scale.x;
+        components[8][i] = scale.y;
+        components[9][i] = scale.z;
+    }
+
+    glm::mat4* models = arena.allocateArray<glm::mat4>(count);
+    glm::mat3* normals = arena.allocateArray<glm::mat3>(count);
+
+    auto body = [&](size_t begin, size_t end) {
+        TransformBatchInput input{
+            components[0] + begin, components[1] + begin, components[2] + begin,
+            components[3] + begin, components[4] + begin, components[5] + begin, components[6] + begin,
+            components[7] + begin, components[8] + begin, components[9] + begin
+        };
+        composeTransformBatch(input, end - begin, models + begin, normals + begin);
+
+        for (size_t i = begin; i < end; ++i) {
+            transforms[i]->setLocalMatrices(models[i], normals[i]);
+        }
+        };
+
+    if (jobSystem) {
+        jobSystem->parallelFor(count, ComposeGrainSize, body);
+    }
+    else {
+        body(0, count);
+    }
+}
+
+void SystemScheduler::runSystems(float deltaTime, const FrameVector<GameObject*>& objects) {
+    buildGraph();
+    if (nodes.empty()) return;
+
+    PROFILE_SCOPE("Systems");
+
+    // Системы разрешают дескрипторы с рабочих потоков: таблица на это время только читается,
+    // а строки архетипов не переезжают (изменения из систем - через CommandBuffer)
+    EntityRegistry::ParallelReadScope readScope;
+    ArchetypeStorage::StructuralLock structuralLock;
+    SystemContext context(deltaTime, jobSystem, objects);
+
+    // Без рабочих потоков - последовательно в порядке добавления (он согласован с графом)
+    if (!jobSystem || jobSystem->getWorkerCount() == 0) {
+        for (const Node& node : nodes) {
+            PROFILE_SCOPE(node.system->getName());
+            node.system->update(context);
+        }
+        return;
+    }
+
+    // Запускаем узлы без зависимостей, остальные запускает последняя из их зависимостей
+    JobCounter counter;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].dependencyCount == 0) {
+            jobSystem->schedule([this, i, &context, &counter]() { runNode(i, context, counter); }, &counter);
+        }
+    }
+    jobSystem->wait(counter);
+}
+
+void SystemScheduler::buildGraph() {
+    // Узлы переиспользуются между шагами вместе с памятью списков зависимых
+    size_t count = 0;
+    for (const auto& system : systems) {
+        if (!system->isEnabled()) continue;
+
+        if (count == nodes.size()) nodes.emplace_back();
+        Node& node = nodes[count++];
+        node.system = system.get();
+        node.dependents.clear();
+        node.dependencyCount = 0;
+    }
+    nodes.resize(count);
+
+    // Система зависит от каждой более ранней системы, с которой конфликтует
+    for (size_t later = 0; later < nodes.size(); ++later) {
+        for (size_t earlier = 0; earlier < later; ++earlier) {
+            if (nodes[later].system->conflictsWith(*nodes[earlier].system)) {
+                nodes[earlier].dependents.push_back(later);
+                ++nodes[later].dependencyCount;
+            }
+        }
+    }
+
+    if (remainingCapacity < nodes.size()) {
+        remaining = std::make_unique<std::atomic<int>[]>(nodes.size());
+        remainingCapacity = nodes.size();
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        remaining[i].store(nodes[i].dependencyCount, std::memory_order_relaxed);
+    }
+}
+
+void SystemScheduler::runNode(size_t index, const SystemContext& context, JobCounter& counter) {
+    const Node& node = nodes[index];
+    {
+        PROFILE_SCOPE(node.system->getName());
+        node.system->update(context);
+    }
+
+    // Задания зависимых систем ставятся до завершения текущего - счетчик не обнулится раньше времени
+    for (size_t dependent : node.dependents) {
+        if (remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            jobSystem->schedule([this, dependent, &context, &counter]() { runNode(dependent, context, counter); }, &counter);
+        }
+    }
+}
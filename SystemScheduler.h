@@ -0,0 +1,78 @@
+#pragma once
+#include "System.h"
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Scene;
+class SceneHierarchy;
+
+// ==================== Планировщик систем ====================
+// Каждый шаг симуляции строит граф зависимостей систем по объявленному доступу:
+// система ждет все ранее добавленные системы, с которыми конфликтует, остальные
+// выполняются параллельно на JobSystem. Перед системами (если не отключено) последовательно
+// вызывается Scene::update - компоненты с виртуальным update продолжают работать.
+// После систем применяются отложенные структурные изменения (CommandBuffer) и пересчитываются
+// мировые матрицы Transform
+class SystemScheduler {
+public:
+    // jobSystem == nullptr - все системы выполняются последовательно в вызывающем потоке
+    explicit SystemScheduler(JobSystem* jobSystem) : jobSystem(jobSystem) {}
+
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    // ==================== Системы ====================
+    // Порядок добавления задает порядок выполнения конфликтующих систем
+    template<typename T, typename... Args>
+    T* addSystem(Args&&... args) {
+        static_assert(std::is_base_of<System, T>::value, "T должен наследоваться от System");
+        auto system = std::make_unique<T>(std::forward<Args>(args)...);
+        T* ptr = system.get();
+        systems.push_back(std::move(system));
+        return ptr;
+    }
+
+    void removeSystem(System* system);
+    const std::vector<std::unique_ptr<System>>& getSystems() const { return systems; }
+
+    // ==================== Шаг симуляции ====================
+    // Компоненты обновляются линейным проходом Scene::update, системы - по активным объектам сцены
+    void update(float deltaTime, Scene& scene);
+
+    // Пересчет мировых матриц измененных объектов по плоской иерархии сцены: линейный проход,
+    // поддеревья корней - параллельно. Вызывается в конце update
+    void updateTransforms(const SceneHierarchy& hierarchy);
+
+    // Последовательный вызов Scene::update перед системами
+    void setComponentUpdateEnabled(bool enable) { componentUpdate = enable; }
+    bool isComponentUpdateEnabled() const { return componentUpdate; }
+
+private:
+    // Узел графа: система и зависящие от нее системы
+    struct Node {
+        System* system = nullptr;
+        std::vector<size_t> dependents;
+        int dependencyCount = 0;
+    };
+
+    // Корневых поддеревьев на одно задание при пересчете матриц
+    static constexpr size_t TransformGrainSize = 16;
+    // Объектов на одно задание при пакетной сборке локальных матриц
+    static constexpr size_t ComposeGrainSize = 1024;
+
+    void composeLocalMatrices(const FrameVector<Transform*>& transforms, FrameArena& arena);
+    void runSystems(float deltaTime, const FrameVector<GameObject*>& objects);
+    void buildGraph();
+    void runNode(size_t index, const SystemContext& context, JobCounter& counter);
+
+    JobSystem* jobSystem;
+    std::vector<std::unique_ptr<System>> systems;
+    bool componentUpdate = true;
+
+    // Граф текущего шага (память переиспользуется между шагами)
+    std::vector<Node> nodes;
+    std::unique_ptr<std::atomic<int>[]> remaining;     // Незавершенные зависимости узлов
+    size_t remainingCapacity = 0;
+};
@@ -6,11 +6,6 @@
 
 class Transform : public Component {
 public:
-    // Публичные поля для упрощения доступа
-    glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f);
-    glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
-    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-
     // Конструкторы
     Transform() = default;
     Transform(const glm::vec3& pos, const glm::vec3& scl = glm::vec3(1.0f),
@@ -18,13 +13,154 @@ public:
         : position(pos), scale(scl), rotation(rot) {
     }
 
-    // Получение матрицы модели
-    glm::mat4 getModelMatrix() const {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, position);
-        model = model * glm::mat4_cast(rotation);
-        model = glm::scale(model, scale);
-        return model;
+    // ==================== Локальное состояние ====================
+    // Изменение через сеттеры помечает матрицы устаревшими
+
+    const glm::vec3& getPosition() const { return position; }
+    const glm::vec3& getScale() const { return scale; }
+    const glm::quat& getRotation() const { return rotation; }
+
+    void setPosition(const glm::vec3& value) { position = value; markDirty(); }
+    void setScale(const glm::vec3& value) { scale = value; markDirty(); }
+    void setRotation(const glm::quat& value) { rotation = value; markDirty(); }
+
+    // Матрица относительно родителя
+    glm::mat4 getLocalMatrix() const { return localValid ? localMatrix : composeMatrix(position, rotation, scale); }
+    glm::mat3 getLocalNormalMatrix() const {
+        return localValid ? localNormalMatrix : composeNormalMatrix(rotation, scale);
+    }
+
+    // Локальные матрицы, собранные пакетно (composeTransformBatch); действительны до следующего изменения
+    void setLocalMatrices(const glm::mat4& model, const glm::mat3& normal) {
+        localMatrix = model;
+        localNormalMatrix = normal;
+        localValid = true;
+    }
+
+    // ==================== Мировая матрица ====================
+    // Кэшируется и пересчитывается проходом по иерархии (SystemScheduler::updateTransforms)
+    // только у измененных объектов и их потомков
+
+    // Мировая матрица. Если объект изменен после прохода, матрица собирается заново
+    // с последней известной матрицей родителя
+    glm::mat4 getWorldMatrix() const {
+        if (dirty) return hasParent ? parentMatrix * getLocalMatrix() : getLocalMatrix();
+        return worldMatrix;
+    }
+
+    // Матрица модели для рендеринга (мировая)
+    glm::mat4 getModelMatrix() const { return getWorldMatrix(); }
+
+    // Матрица нормалей (обратная транспонированная к мировой 3x3) - вместо inverse() в шейдере
+    glm::mat3 getNormalMatrix() const {
+        if (dirty) return hasParent ? parentNormalMatrix * getLocalNormalMatrix() : getLocalNormalMatrix();
+        return normalMatrix;
+    }
+
+    bool isDirty() const { return dirty; }
+
+    // Мировая позиция по последнему проходу иерархии (без пересборки матриц)
+    glm::vec3 getCachedWorldPosition() const { return glm::vec3(worldMatrix[3]); }
+
+    // Пересчет мировых матриц (parent == nullptr - корневой объект).
+    // Возвращает true, если матрицы изменились и потомков тоже нужно пересчитать
+    bool updateWorldMatrix(const Transform* parent, bool parentChanged) {
+        if (!dirty && !parentChanged) return false;
+
+        if (!localValid) {
+            setLocalMatrices(composeMatrix(position, rotation, scale), composeNormalMatrix(rotation, scale));
+        }
+
+        hasParent = parent != nullptr;
+        if (hasParent) {
+            parentMatrix = parent->worldMatrix;
+            parentNormalMatrix = parent->normalMatrix;
+            worldMatrix = parentMatrix * localMatrix;
+            normalMatrix = parentNormalMatrix * localNormalMatrix;
+        }
+        else {
+            worldMatrix = localMatrix;
+            normalMatrix = localNormalMatrix;
+        }
+        dirty = false;
+
+        // Первый пересчет: интерполировать не из чего, объект появляется сразу на месте
+        if (!worldComputed) {
+            previousWorldMatrix = worldMatrix;
+            worldComputed = true;
+        }
+        else {
+            worldChangedThisStep = true;
+        }
+        return true;
+    }
+
+    // Разложение мировой матрицы на позицию, поворот и масштаб (сдвиг от неравномерного
+    // масштаба родителя теряется - для интерполяции этого достаточно)
+    static void decomposeMatrix(const glm::mat4& matrix, glm::vec3& position, glm::quat& rotation, glm::vec3& scale) {
+        glm::mat3 basis(matrix);
+        position = glm::vec3(matrix[3]);
+        scale = glm::vec3(glm::length(basis[0]), glm::length(basis[1]), glm::length(basis[2]));
+        if (glm::determinant(basis) < 0.0f) scale.x = -scale.x;
+
+        // Вырожденный масштаб: поворот не определен
+        if (scale.x == 0.0f || scale.y == 0.0f || scale.z == 0.0f) {
+            rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+            return;
+        }
+        rotation = glm::normalize(glm::quat_cast(glm::mat3(basis[0] / scale.x, basis[1] / scale.y, basis[2] / scale.z)));
+    }
+
+    // Сборка TRS-матрицы без промежуточных умножений 4x4
+    static glm::mat4 composeMatrix(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+        glm::mat3 basis = glm::mat3_cast(rotation);
+        return glm::mat4(
+            glm::vec4(basis[0] * scale.x, 0.0f),
+            glm::vec4(basis[1] * scale.y, 0.0f),
+            glm::vec4(basis[2] * scale.z, 0.0f),
+            glm::vec4(position, 1.0f));
+    }
+
+    // Матрица нормалей для TRS: (R * S)^-T = R * S^-1
+    static glm::mat3 composeNormalMatrix(const glm::quat& rotation, const glm::vec3& scale) {
+        glm::mat3 basis = glm::mat3_cast(rotation);
+        return glm::mat3(basis[0] / scale.x, basis[1] / scale.y, basis[2] / scale.z);
+    }
+
+    // ==================== Интерполяция ====================
+    // Симуляция идет с фиксированным шагом, а рендеринг - с частотой кадров.
+    // Проход иерархии перед пересчетом запоминает мировую матрицу прошлого шага, а при отрисовке
+    // предыдущее и текущее состояние смешиваются с коэффициентом Core::getInterpolationAlpha().
+    // Запоминание не зависит от update компонентов (TickPolicy, setComponentUpdateEnabled).
+    // Смешивание идет в мировом пространстве, поэтому дочерние объекты движущегося
+    // родителя интерполируются вместе с ним
+
+    // Запомнить мировую матрицу прошлого шага (вызывается из SystemScheduler::updateTransforms
+    // перед updateWorldMatrix). Если за прошлый шаг матрица не менялась, копия уже совпадает
+    void storePreviousState() {
+        if (!worldChangedThisStep) return;
+        previousWorldMatrix = worldMatrix;
+        worldChangedThisStep = false;
+    }
+
+    // Матрица модели между предыдущим (alpha = 0) и текущим (alpha = 1) шагом.
+    // Объект, мировая матрица которого за шаг не менялась, получает кэшированную
+    glm::mat4 getInterpolatedModelMatrix(float alpha) const {
+        if (!isInterpolated(alpha)) return getWorldMatrix();
+
+        glm::vec3 worldPosition, worldScale;
+        glm::quat worldRotation;
+        interpolateWorld(alpha, worldPosition, worldRotation, worldScale);
+        return composeMatrix(worldPosition, worldRotation, worldScale);
+    }
+
+    glm::mat3 getInterpolatedNormalMatrix(float alpha) const {
+        if (!isInterpolated(alpha)) return getNormalMatrix();
+
+        glm::vec3 worldPosition, worldScale;
+        glm::quat worldRotation;
+        interpolateWorld(alpha, worldPosition, worldRotation, worldScale);
+        return composeNormalMatrix(worldRotation, worldScale);
     }
 
     // Методы трансформации
@@ -35,12 +171,17 @@ public:
         else {
             position += translation;
         }
+        markDirty();
     }
 
     void rotate(float angle, const glm::vec3& axis) {
         rotation = glm::rotate(rotation, glm::radians(angle), axis);
+        markDirty();
     }
 
+    // Мировая матрица устарела без изменения локального состояния (смена родителя)
+    void invalidateWorld() { dirty = true; }
+
     // Получение направляющих векторов
     glm::vec3 getForward() const { return rotation * glm::vec3(0.0f, 0.0f, -1.0f); }
     glm::vec3 getRight() const { return rotation * glm::vec3(1.0f, 0.0f, 0.0f); }
@@ -48,4 +189,44 @@ public:
 
     // Регистрация компонента
     REGISTER_COMPONENT(Transform)
+
+private:
+    void markDirty() {
+        dirty = true;
+        localValid = false;
+    }
+
+    bool isInterpolated(float alpha) const { return alpha < 1.0f && worldComputed && (worldChangedThisStep || dirty); }
+
+    // Раскладываются только матрицы объектов, которые действительно интерполируются
+    void interpolateWorld(float alpha, glm::vec3& worldPosition, glm::quat& worldRotation, glm::vec3& worldScale) const {
+        glm::vec3 previousPosition, previousScale;
+        glm::quat previousRotation;
+        decomposeMatrix(previousWorldMatrix, previousPosition, previousRotation, previousScale);
+        decomposeMatrix(getWorldMatrix(), worldPosition, worldRotation, worldScale);
+        worldPosition = glm::mix(previousPosition, worldPosition, alpha);
+        worldRotation = glm::slerp(previousRotation, worldRotation, alpha);
+        worldScale = glm::mix(previousScale, worldScale, alpha);
+    }
+
+    // Локальное состояние (относительно родителя)
+    glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f);
+    glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+
+    // Кэш матриц
+    glm::mat4 localMatrix = glm::mat4(1.0f);
+    glm::mat3 localNormalMatrix = glm::mat3(1.0f);
+    glm::mat4 worldMatrix = glm::mat4(1.0f);
+    glm::mat3 normalMatrix = glm::mat3(1.0f);
+    glm::mat4 parentMatrix = glm::mat4(1.0f);     // Мировые матрицы родителя при последнем пересчете
+    glm::mat3 parentNormalMatrix = glm::mat3(1.0f);
+    bool hasParent = false;
+    bool localValid = false;                       // localMatrix соответствует локальному состоянию
+    bool dirty = true;                             // Локальное состояние изменено после пересчета
+    bool worldChangedThisStep = false;             // Мировая матрица пересчитана на текущем шаге
+    bool worldComputed = false;                    // Был хотя бы один проход иерархии
+
+    // Мировая матрица на предыдущем шаге симуляции
+    glm::mat4 previousWorldMatrix = glm::mat4(1.0f);
 };
\ No newline at end of file
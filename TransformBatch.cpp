@@ -0,0 +1,134 @@
+#include "TransformBatch.h"
+#include "TransformBatchKernel.h"
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ENGINE_TRANSFORM_BATCH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Ядро AVX2 (TransformBatchAvx2.cpp)
+size_t composeTransformBatchAvx2(const TransformBatchInput& input, size_t begin, size_t end,
+    float* models, float* normals);
+#endif
+
+namespace {
+    // ==================== Наборы команд ====================
+    struct ScalarOps {
+        using Vec = float;
+        static constexpr size_t Width = 1;
+
+        static Vec load(const float* source) { return *source; }
+        static Vec set(float value) { return value; }
+        static void store(float* destination, Vec value) { *destination = value; }
+        static Vec add(Vec a, Vec b) { return a + b; }
+        static Vec sub(Vec a, Vec b) { return a - b; }
+        static Vec mul(Vec a, Vec b) { return a * b; }
+        static Vec div(Vec a, Vec b) { return a / b; }
+    };
+
+#ifdef ENGINE_TRANSFORM_BATCH_X86
+    // SSE2 есть у любого процессора x64, проверка не нужна
+    struct SseOps {
+        using Vec = __m128;
+        static constexpr size_t Width = 4;
+
+        static Vec load(const float* source) { return _mm_loadu_ps(source); }
+        static Vec set(float value) { return _mm_set1_ps(value); }
+        static void store(float* destination, Vec value) { _mm_store_ps(destination, value); }
+        static Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+        static Vec div(Vec a, Vec b) { return _mm_div_ps(a, b); }
+    };
+
+    // AVX2 нужен и процессору, и ОС (сохранение регистров YMM при переключении потоков)
+    bool isAvx2Supported() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    TransformBatchPath detectBestPath() {
+#ifdef ENGINE_TRANSFORM_BATCH_X86
+        return isAvx2Supported() ? TransformBatchPath::AVX2 : TransformBatchPath::SSE;
+#else
+        return TransformBatchPath::Scalar;
+#endif
+    }
+
+    TransformBatchPath bestPath() {
+        static const TransformBatchPath path = detectBestPath();
+        return path;
+    }
+
+    std::atomic<TransformBatchPath> selectedPath{ TransformBatchPath::Scalar };
+    std::atomic<bool> pathSelected{ false };
+}
+
+// ==================== Выбор набора команд ====================
+TransformBatchPath getTransformBatchPath() {
+    if (!pathSelected.load(std::memory_order_acquire)) {
+        selectedPath.store(bestPath(), std::memory_order_relaxed);
+        pathSelected.store(true, std::memory_order_release);
+    }
+    return selectedPath.load(std::memory_order_relaxed);
+}
+
+void setTransformBatchPath(TransformBatchPath path) {
+    // Более широкий путь, чем поддерживает процессор, недоступен
+    if (static_cast<int>(path) > static_cast<int>(bestPath())) {
+        path = bestPath();
+    }
+    selectedPath.store(path, std::memory_order_relaxed);
+    pathSelected.store(true, std::memory_order_release);
+}
+
+const char* getTransformBatchPathName(TransformBatchPath path) {
+    switch (path) {
+    case TransformBatchPath::AVX2: return "AVX2";
+    case TransformBatchPath::SSE: return "SSE";
+    default: return "Scalar";
+    }
+}
+
+// ==================== Сборка матриц ====================
+void composeTransformBatch(const TransformBatchInput& input, size_t count, glm::mat4* models, glm::mat3* normals) {
+    float* modelData = reinterpret_cast<float*>(models);
+    float* normalData = normals ? reinterpret_cast<float*>(normals) : nullptr;
+    size_t done = 0;
+
+#ifdef ENGINE_TRANSFORM_BATCH_X86
+    switch (getTransformBatchPath()) {
+    case TransformBatchPath::AVX2:
+        done = composeTransformBatchAvx2(input, 0, count, modelData, normalData);
+        done = composeTransformKernel<SseOps>(input, done, count, modelData, normalData);
+        break;
+    case TransformBatchPath::SSE:
+        done = composeTransformKernel<SseOps>(input, 0, count, modelData, normalData);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    // Остаток, не заполнивший вектор
+    composeTransformKernel<ScalarOps>(input, done, count, modelData, normalData);
+}
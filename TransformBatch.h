@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// ==================== Пакетная сборка матриц Transform ====================
+// Данные N объектов в виде структуры массивов (SoA): каждая компонента - отдельный массив.
+// Ядро собирает из них матрицы модели (T * R * S) и матрицы нормалей (R * S^-1)
+// сразу для нескольких объектов командами SIMD
+struct TransformBatchInput {
+    const float* positionX;
+    const float* positionY;
+    const float* positionZ;
+    const float* rotationX;     // Кватернион (x, y, z, w), нормированный
+    const float* rotationY;
+    const float* rotationZ;
+    const float* rotationW;
+    const float* scaleX;
+    const float* scaleY;
+    const float* scaleZ;
+};
+
+// Набор команд ядра
+enum class TransformBatchPath {
+    Scalar,
+    SSE,        // 4 объекта за итерацию
+    AVX2        // 8 объектов за итерацию
+};
+
+// Сборка матриц объектов [0, count). normals может быть nullptr.
+// Набор команд выбирается один раз при первом вызове по возможностям процессора
+void composeTransformBatch(const TransformBatchInput& input, size_t count, glm::mat4* models, glm::mat3* normals);
+
+// Выбранный набор команд (и принудительный выбор - для сравнения производительности;
+// путь, не поддерживаемый процессором, заменяется лучшим доступным)
+TransformBatchPath getTransformBatchPath();
+void setTransformBatchPath(TransformBatchPath path);
+const char* getTransformBatchPathName(TransformBatchPath path);
@@ -0,0 +1,45 @@
+#include "TransformBatch.h"
+
+// Ядро AVX2 для composeTransformBatch. Вызывается только после проверки поддержки процессором.
+// GCC и Clang генерируют AVX2 только для кода после pragma (заголовки glm подключены выше
+// и остаются без AVX); MSVC разрешает интринсики AVX2 без /arch
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+
+#if defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include <immintrin.h>
+#include "TransformBatchKernel.h"
+
+namespace {
+    struct Avx2Ops {
+        using Vec = __m256;
+        static constexpr size_t Width = 8;
+
+        static Vec load(const float* source) { return _mm256_loadu_ps(source); }
+        static Vec set(float value) { return _mm256_set1_ps(value); }
+        static void store(float* destination, Vec value) { _mm256_store_ps(destination, value); }
+        static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+        static Vec div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+    };
+}
+
+size_t composeTransformBatchAvx2(const TransformBatchInput& input, size_t begin, size_t end,
+    float* models, float* normals) {
+    size_t done = composeTransformKernel<Avx2Ops>(input, begin, end, models, normals);
+
+    // Переход от AVX к SSE-коду без штрафа за грязные старшие половины регистров
+    _mm256_zeroupper();
+    return done;
+}
+
+#if defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
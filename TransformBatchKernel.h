@@ -0,0 +1,99 @@
+#pragma once
+#include "TransformBatch.h"
+
+// ==================== Ядро сборки матриц ====================
+// Общий код для всех наборов команд. Ops описывает вектор из Ops::Width чисел:
+// Vec, load (невыровненная загрузка), set (одно число во все элементы), store и арифметика.
+// Подключается только файлами реализации, каждый со своими Ops во внутреннем пространстве имен.
+// Обрабатывает полные группы по Width объектов и возвращает индекс первого необработанного.
+// Матрицы пишутся как массивы float (16 и 9 чисел по столбцам, раскладка glm::mat4/glm::mat3):
+// ядро не вызывает функций glm, чтобы файл с другим набором команд не порождал их копий
+template<typename Ops>
+size_t composeTransformKernel(const TransformBatchInput& in, size_t begin, size_t end,
+    float* models, float* normals) {
+    using Vec = typename Ops::Vec;
+    constexpr size_t Width = Ops::Width;
+
+    const Vec one = Ops::set(1.0f);
+    const Vec two = Ops::set(2.0f);
+
+    // Результаты группы по компонентам (SoA) перед записью в матрицы объектов
+    alignas(32) float model[12][Width];
+    alignas(32) float normal[9][Width];
+
+    size_t i = begin;
+    for (; i + Width <= end; i += Width) {
+        Vec x = Ops::load(in.rotationX + i);
+        Vec y = Ops::load(in.rotationY + i);
+        Vec z = Ops::load(in.rotationZ + i);
+        Vec w = Ops::load(in.rotationW + i);
+        Vec sx = Ops::load(in.scaleX + i);
+        Vec sy = Ops::load(in.scaleY + i);
+        Vec sz = Ops::load(in.scaleZ + i);
+
+        // Матрица поворота из кватерниона (как glm::mat3_cast, по столбцам)
+        Vec xx = Ops::mul(x, x), yy = Ops::mul(y, y), zz = Ops::mul(z, z);
+        Vec xy = Ops::mul(x, y), xz = Ops::mul(x, z), yz = Ops::mul(y, z);
+        Vec wx = Ops::mul(w, x), wy = Ops::mul(w, y), wz = Ops::mul(w, z);
+
+        Vec r00 = Ops::sub(one, Ops::mul(two, Ops::add(yy, zz)));
+        Vec r01 = Ops::mul(two, Ops::add(xy, wz));
+        Vec r02 = Ops::mul(two, Ops::sub(xz, wy));
+        Vec r10 = Ops::mul(two, Ops::sub(xy, wz));
+        Vec r11 = Ops::sub(one, Ops::mul(two, Ops::add(xx, zz)));
+        Vec r12 = Ops::mul(two, Ops::add(yz, wx));
+        Vec r20 = Ops::mul(two, Ops::add(xz, wy));
+        Vec r21 = Ops::mul(two, Ops::sub(yz, wx));
+        Vec r22 = Ops::sub(one, Ops::mul(two, Ops::add(xx, yy)));
+
+        // Модель: столбцы поворота, умноженные на масштаб, и перенос
+        Ops::store(model[0], Ops::mul(r00, sx));
+        Ops::store(model[1], Ops::mul(r01, sx));
+        Ops::store(model[2], Ops::mul(r02, sx));
+        Ops::store(model[3], Ops::mul(r10, sy));
+        Ops::store(model[4], Ops::mul(r11, sy));
+        Ops::store(model[5], Ops::mul(r12, sy));
+        Ops::store(model[6], Ops::mul(r20, sz));
+        Ops::store(model[7], Ops::mul(r21, sz));
+        Ops::store(model[8], Ops::mul(r22, sz));
+        Ops::store(model[9], Ops::load(in.positionX + i));
+        Ops::store(model[10], Ops::load(in.positionY + i));
+        Ops::store(model[11], Ops::load(in.positionZ + i));
+
+        // Нормали: (R * S)^-T = R * S^-1 - столбцы поворота, деленные на масштаб
+        if (normals) {
+            Vec ix = Ops::div(one, sx), iy = Ops::div(one, sy), iz = Ops::div(one, sz);
+            Ops::store(normal[0], Ops::mul(r00, ix));
+            Ops::store(normal[1], Ops::mul(r01, ix));
+            Ops::store(normal[2], Ops::mul(r02, ix));
+            Ops::store(normal[3], Ops::mul(r10, iy));
+            Ops::store(normal[4], Ops::mul(r11, iy));
+            Ops::store(normal[5], Ops::mul(r12, iy));
+            Ops::store(normal[6], Ops::mul(r20, iz));
+            Ops::store(normal[7], Ops::mul(r21, iz));
+            Ops::store(normal[8], Ops::mul(r22, iz));
+        }
+
+        for (size_t lane = 0; lane < Width; ++lane) {
+            float* m = models + (i + lane) * 16;
+            for (size_t column = 0; column < 3; ++column) {
+                m[column * 4 + 0] = model[column * 3 + 0][lane];
+                m[column * 4 + 1] = model[column * 3 + 1][lane];
+                m[column * 4 + 2] = model[column * 3 + 2][lane];
+                m[column * 4 + 3] = 0.0f;
+            }
+            m[12] = model[9][lane];
+            m[13] = model[10][lane];
+            m[14] = model[11][lane];
+            m[15] = 1.0f;
+
+            if (normals) {
+                float* n = normals + (i + lane) * 9;
+                for (size_t component = 0; component < 9; ++component) {
+                    n[component] = normal[component][lane];
+                }
+            }
+        }
+    }
+    return i;
+}